@@ -6,99 +6,171 @@
  * On https://github.com/arthus-leroy/Python
  * All rights reserved. */
 
-// WARNING: need to use "sudo chmod +s /usr/bin/gdb" to allow gdb capture here
-// Look at Ubuntu Wiki - Kernel hardening
+// WARNING: the functions of the executable are only named if it exports them (link with -rdynamic)
 
 # include "backtrace.hh"
 
-# if defined(__unix) and defined(BACKTRACE)
-    # include <errno.h>
-    # include <stdio.h>
-    # include <stdlib.h>
-    # include <string.h>
-    # include <sys/wait.h>
-    # include <unistd.h>
+# if defined(__unix)
+    # include <cstdint>
+    # include <cstdio>
+    # include <cstdlib>
+    # include <mutex>
+    # include <unordered_map>
 
-    # define ERR() throw Error(strerror(errno))
+    # include <cxxabi.h>
+    # include <dlfcn.h>
+    # include <unistd.h>
+    # include <unwind.h>
 
-    void backtrace(unsigned skip)
+    namespace
     {
-        char pid_buf[30];
-        const int pid = getpid();
-        sprintf(pid_buf, "--pid=%d", pid);
+        /// State of the unwinding, on the stack of the capture
+        struct Capture
+        {
+            void** frames;
+            std::size_t size;
+            std::size_t max;
+            unsigned skip;
+        };
 
-        char name_buf[512];
-        name_buf[readlink("/proc/self/exe", name_buf, 511)] = 0;
+        _Unwind_Reason_Code unwind(_Unwind_Context* context, void* arg)
+        {
+            auto& capture = *static_cast<Capture*>(arg);
 
-        int p[2];
-        if (pipe(p) == -1)
-            ERR();
+            if (capture.skip)
+            {
+                capture.skip--;
+                return _URC_NO_REASON;
+            }
+
+            if (capture.size == capture.max)
+                return _URC_END_OF_STACK;
+
+            const auto ip = _Unwind_GetIP(context);
+            if (ip == 0)
+                return _URC_END_OF_STACK;
+
+            capture.frames[capture.size++] = reinterpret_cast<void*>(ip);
+
+            return _URC_NO_REASON;
+        }
 
-        int child_pid = fork();
-        if (child_pid == -1)
-            ERR();
-        else if (child_pid == 0)
+        /// Name the code at \var address (cached, the same frames come back often)
+        std::string symbolize(void* address)
         {
-            if (dup2(p[1], STDOUT_FILENO) == -1)    // redirect stdout to in
-                ERR();
-            if (dup2(p[1], STDERR_FILENO) == -1)    // redirect stderr to in
-                ERR();
+            static std::mutex mutex;
+            static std::unordered_map<void*, std::string> cache;
 
-            close(p[1]);                            // close now useless in
-            close(p[0]);                            // and close useless out
+            std::lock_guard<std::mutex> lock(mutex);
 
-            fprintf(stdout, "stack trace for %s pid=%d\n", name_buf, pid);
-            execlp("gdb", "gdb", "--batch", "-n", "-ex", "thread", "-ex", "bt", name_buf, pid_buf, NULL);
+            auto entry = cache.find(address);
+            if (entry != cache.end())
+                return entry->second;
 
-            ERR();  // exec should have replaced the program, but failed
+            std::string symbol = "??";
+            char buffer[32];
+
+            Dl_info info{};
+            const bool found = dladdr(address, &info) != 0;
+
+            if (found && info.dli_sname)
+            {
+                int status;
+                char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                symbol = status == 0 ? demangled : info.dli_sname;
+                free(demangled);
+
+                snprintf(buffer, sizeof(buffer), "+0x%lx",
+                         static_cast<unsigned long>(static_cast<char*>(address) - static_cast<char*>(info.dli_saddr)));
+                symbol += buffer;
+            }
+            else
+            {
+                snprintf(buffer, sizeof(buffer), "%p", address);
+                symbol += std::string(" at ") + buffer;
+            }
+
+            if (found && info.dli_fname && *info.dli_fname)
+                symbol += std::string(" (") + info.dli_fname + ")";
+
+            return cache.emplace(address, symbol).first->second;
         }
-        else
+    }
+
+    __attribute__((noinline)) StackTrace::StackTrace(unsigned skip)
+    {
+        // skip the constructor itself
+        Capture capture = { frames_.data(), 0, max_frames, skip + 1 };
+        _Unwind_Backtrace(unwind, &capture);
+
+        size_ = capture.size;
+    }
+
+    const std::vector<std::string>& StackTrace::symbols(void) const
+    {
+        if (symbols_.size() != size_)
         {
-            char c;
+            symbols_.clear();
+            for (std::size_t i = 0; i < size_; i++)
+                symbols_.push_back(symbolize(frames_[i]));
+        }
 
-            waitpid(child_pid, NULL, 0);        // wait for out
+        return symbols_;
+    }
 
-            close(p[1]);                        // close in
+    void StackTrace::write(int fd) const
+    {
+        // formatted by hand, snprintf is not async-signal-safe
+        char line[2 * sizeof(void*) + 3];
 
-            // skip "waitpid" and "backtrace" in output
-            skip += 2;
-            unsigned skip_space = 0;
-            bool line = false;
+        for (std::size_t i = 0; i < size_; i++)
+        {
+            auto address = reinterpret_cast<std::uintptr_t>(frames_[i]);
+            std::size_t end = sizeof(line) - 1;
 
-            int err;
-            while ((err = read(p[0], &c, 1)) > 0)     // and read in
+            line[end] = '\n';
+            do
             {
-                // begin delimiter
-                if (c == '#' && line == false)
-                {
-                    if (skip == 0)
-                        fprintf(stderr, "    ");
-
-                    skip_space = 0;
-                    line = true;
-                }
-
-                // between '#' and '\n' after skipping X spaces and Y lines
-                if (line && skip == 0 && skip_space > 2)
-                    fputc(c, stderr);
-
-                // number of spaces skipped
-                if (line && c == ' ')
-                    skip_space++;
-
-                // end delimiter
-                if (line && c == '\n')
-                {
-                    if (skip)
-                        skip--;
-                    line = false;
-                }
+                line[--end] = "0123456789abcdef"[address & 0xf];
+                address >>= 4;
             }
-            if (err == -1)
-                ERR();
+            while (address);
 
-            close(p[1]);
+            // keep the "0x" prefix right before the digits
+            line[--end] = 'x';
+            line[--end] = '0';
+
+            if (::write(fd, line + end, sizeof(line) - end) < 0)
+                return;
         }
+    }
+# else
+    StackTrace::StackTrace(unsigned)
+    {}
+
+    const std::vector<std::string>& StackTrace::symbols(void) const
+    {
+        return symbols_;
+    }
+
+    void StackTrace::write(int) const
+    {}
+# endif
+
+void StackTrace::print(std::ostream& out) const
+{
+    const auto& names = symbols();
+
+    for (std::size_t i = 0; i < names.size(); i++)
+        out << "    #" << i << " " << names[i] << "\n";
+    out.flush();
+}
+
+# if defined(BACKTRACE)
+    __attribute__((noinline)) void backtrace(unsigned skip)
+    {
+        // skip "backtrace" in output
+        StackTrace(skip + 1).print();
 
         throw Error("");
     }
@@ -107,5 +179,4 @@
     {
         throw Error("");
     }
-
-# endif
\ No newline at end of file
+# endif
@@ -1,6 +1,10 @@
 # pragma once
 
+# include <array>
 # include <string>
+# include <vector>
+# include <ostream>
+# include <iostream>
 # include <stdexcept>
 
 /// Error throwed by backtrace at the end (to end) or at any internal error of backtrace
@@ -12,5 +16,51 @@ public:
     {}
 };
 
-/// Print the backtrace (requires gdb) and throw an Error exception
-void backtrace(unsigned skip = 0);
\ No newline at end of file
+// NOTE: the capture and write are async-signal-safe (no allocation nor lock) once the unwinder has been
+//       initialized by a first capture (do one before installing a signal handler), symbols and print are not
+/// Native call stack, captured in process (without allocation) and symbolized when printed
+class StackTrace
+{
+public:
+    static constexpr std::size_t max_frames = 64;
+
+    /// Tag to build an empty trace, captured later by assignment
+    struct Empty {};
+
+    static constexpr Empty empty{};
+
+    /// Capture the stack of the caller, skipping its \var skip innermost frames
+    explicit StackTrace(unsigned skip = 0);
+
+    explicit StackTrace(Empty)
+    {}
+
+    /// Number of captured frames
+    std::size_t size(void) const
+    {
+        return size_;
+    }
+
+    /// Address of the \var i-th frame (0 is the innermost)
+    void* operator[](const std::size_t i) const
+    {
+        return frames_[i];
+    }
+
+    /// "function+offset (module)" of each frame, computed once
+    const std::vector<std::string>& symbols(void) const;
+
+    /// Print one frame per line
+    void print(std::ostream& out = std::cerr) const;
+
+    /// Write the address of each frame (one per line, not symbolized) to the file descriptor \var fd
+    void write(int fd) const;
+
+private:
+    std::array<void*, max_frames> frames_;
+    std::size_t size_ = 0;
+    mutable std::vector<std::string> symbols_;
+};
+
+/// Print the backtrace and throw an Error exception
+void backtrace(unsigned skip = 0);
@@ -0,0 +1,143 @@
+// BENCH: indexing, cached lookups and iteration
+
+# include "bench.hh"
+
+int main()
+{
+    bench::initialize();
+
+    std::vector<long> values(100);
+    for (long i = 0; i < 100; i++)
+        values[i] = i;
+
+    auto list = Python(values);
+    PyObject* plist = list;
+
+    // indexing
+    bench::pair("index/list[i]",
+        [&]() { return Python(list[50]); },
+        [&]() { return PyList_GET_ITEM(plist, 50); });
+
+    PyList typed(list);
+    bench::pair("index/PyList[i]",
+        [&]() { return typed[50]; },
+        [&]() { return PyList_GET_ITEM(plist, 50); });
+
+    auto dict = Python::dict("first", 1, "second", 2, "third", 3);
+    PyObject* pdict = dict;
+    auto key = PyRef(PyUnicode_InternFromString("second"), "second");
+
+    bench::pair("index/dict[key]",
+        [&]() { return Python(dict["second"_key]); },
+        [&]() { return PyDict_GetItemWithError(pdict, key); });
+
+    // misses, without and with an exception
+    auto missing = PyRef(PyUnicode_InternFromString("missing"), "missing");
+    bench::pair("miss/dict.get(key)",
+        [&]() { return dict.get("missing"_key); },
+        [&]() { return PyDict_GetItemWithError(pdict, missing); });
+
+    bench::pair("miss/get_attr(key)",
+        [&]() { return list.get_attr("missing"_key); },
+        [&]()
+        {
+            auto o = PyObject_GetAttr(plist, missing);
+            if (o == nullptr && PyErr_ExceptionMatches(PyExc_AttributeError))
+                PyErr_Clear();
+            return o;
+        });
+
+    bench::pair("miss/try_(dict[key])",
+        [&]() { return Python::try_([&]() { return Python(dict["missing"_key]); }); },
+        [&]() { return PyDict_GetItemWithError(pdict, missing); });
+
+    // lookups
+    auto os = Python::import("os");
+    PyObject* pos = os;
+    auto getcwd = PyRef(PyUnicode_InternFromString("getcwd"), "getcwd");
+
+    Python::Lookup getcwd_site("getcwd"_key);
+    bench::pair("lookup/module global",
+        [&]() { return getcwd_site(os); },
+        [&]() { return PyDict_GetItemWithError(pos, getcwd); });
+
+    auto path = PyRef(PyUnicode_InternFromString("path"), "path");
+    auto join = PyRef(PyUnicode_InternFromString("join"), "join");
+    Python::Lookup join_site("path.join");
+    bench::pair("lookup/Lookup(\"path.join\")",
+        [&]() { return join_site(os); },
+        [&]()
+        {
+            auto module = PyDict_GetItemWithError(pos, path);
+            auto o = PyObject_GetAttr(module, join);
+            bench::decref(o);
+        });
+
+    Python::Context context;
+    context.exec("class A:\n    x = 1");
+    auto type = context.eval("A");
+    PyObject* ptype = type;
+    auto x = PyRef(PyUnicode_InternFromString("x"), "x");
+    Python::Lookup x_site("x"_key);
+    bench::pair("lookup/class attribute",
+        [&]() { return x_site(type); },
+        [&]()
+        {
+            auto o = PyObject_GetAttr(ptype, x);
+            bench::decref(o);
+        });
+
+    // iteration
+    bench::pair("iteration/list[100]",
+        [&]()
+        {
+            long sum = 0;
+            for (auto item : list)
+                sum += item.as<long>();
+            return sum;
+        },
+        [&]()
+        {
+            long sum = 0;
+            for (Py_ssize_t i = 0; i < PyList_GET_SIZE(plist); i++)
+                sum += PyLong_AsLong(PyList_GET_ITEM(plist, i));
+            return sum;
+        });
+
+    bench::pair("iteration/PyList[100]",
+        [&]()
+        {
+            long sum = 0;
+            for (Py_ssize_t i = 0; i < typed.size(); i++)
+                sum += typed[i].as<long>();
+            return sum;
+        },
+        [&]()
+        {
+            long sum = 0;
+            for (Py_ssize_t i = 0; i < PyList_GET_SIZE(plist); i++)
+                sum += PyLong_AsLong(PyList_GET_ITEM(plist, i));
+            return sum;
+        });
+
+    bench::pair("iteration/dict.items()",
+        [&]()
+        {
+            long sum = 0;
+            for (auto [k, v] : dict.items())
+                sum += v.as<long>();
+            return sum;
+        },
+        [&]()
+        {
+            long sum = 0;
+            Py_ssize_t pos = 0;
+            PyObject* k = nullptr;
+            PyObject* v = nullptr;
+            while (PyDict_Next(pdict, &pos, &k, &v))
+                sum += PyLong_AsLong(v);
+            return sum;
+        });
+
+    bench::report();
+}
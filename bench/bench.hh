@@ -0,0 +1,210 @@
+# pragma once
+
+// Microbenchmarks pairing each python.hh operation with its hand-written C-API equivalent
+// Each benchmark reports, per operation:
+//  - ns_per_op: wall time
+//  - allocs_per_op: calls to the python allocators (all domains) and to the C++ operator new
+//  - refcount_ops_per_op: INCREF/DECREF done by PyRef, or by the baseline through incref/decref
+//    (the ones done inside CPython aren't counted)
+
+# ifndef PYDEBUG_COUNT
+    # define PYDEBUG_COUNT
+# endif
+
+# include <chrono>
+# include <cstdio>
+# include <cstdlib>
+# include <new>
+
+# include "python.hh"
+
+namespace bench
+{
+    /// Number of allocations done by the current thread
+    inline thread_local std::size_t allocations = 0;
+
+    /// Allocators wrapped by the counting hooks (raw, mem, obj)
+    inline PyMemAllocatorEx wrapped[3];
+
+    inline void* counted_malloc(void* ctx, std::size_t size)
+    {
+        auto allocator = static_cast<PyMemAllocatorEx*>(ctx);
+        allocations++;
+
+        return allocator->malloc(allocator->ctx, size);
+    }
+
+    inline void* counted_calloc(void* ctx, std::size_t count, std::size_t size)
+    {
+        auto allocator = static_cast<PyMemAllocatorEx*>(ctx);
+        allocations++;
+
+        return allocator->calloc(allocator->ctx, count, size);
+    }
+
+    inline void* counted_realloc(void* ctx, void* ptr, std::size_t size)
+    {
+        auto allocator = static_cast<PyMemAllocatorEx*>(ctx);
+        allocations++;
+
+        return allocator->realloc(allocator->ctx, ptr, size);
+    }
+
+    inline void counted_free(void* ctx, void* ptr)
+    {
+        auto allocator = static_cast<PyMemAllocatorEx*>(ctx);
+        allocator->free(allocator->ctx, ptr);
+    }
+
+    /// Initialize python, then count its allocations (the hooks are installed on top of its allocators)
+    inline void initialize(void)
+    {
+        Python::import("builtins");
+
+        const PyMemAllocatorDomain domains[] = { PYMEM_DOMAIN_RAW, PYMEM_DOMAIN_MEM, PYMEM_DOMAIN_OBJ };
+        for (int i = 0; i < 3; i++)
+        {
+            PyMem_GetAllocator(domains[i], &wrapped[i]);
+
+            PyMemAllocatorEx hook = { &wrapped[i], counted_malloc, counted_calloc, counted_realloc, counted_free };
+            PyMem_SetAllocator(domains[i], &hook);
+        }
+    }
+
+    /// INCREF counted like the ones of PyRef (for the baselines)
+    inline void incref(PyObject* o)
+    {
+        PyRef::refcount_ops++;
+        Py_INCREF(o);
+    }
+
+    /// DECREF counted like the ones of PyRef (for the baselines)
+    inline void decref(PyObject* o)
+    {
+        PyRef::refcount_ops++;
+        Py_DECREF(o);
+    }
+
+    /// Keep \var value from being optimized away
+    template <typename T>
+    inline void keep(T&& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    struct Measure
+    {
+        double ns_per_op;
+        double allocs_per_op;
+        double refcount_ops_per_op;
+    };
+
+    struct Result
+    {
+        std::string name;
+        Measure wrapper;
+        Measure baseline;
+    };
+
+    inline std::vector<Result> results;
+
+    /// Run \var func enough times to last about 50ms, return its cost per call
+    template <typename F>
+    Measure measure(F& func)
+    {
+        using clock = std::chrono::steady_clock;
+
+        auto run = [&func](const std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; i++)
+            {
+                if constexpr(std::is_void<decltype(func())>::value)
+                    func();
+                else
+                    keep(func());
+            }
+        };
+
+        // warm up (interned keys, code objects, caches...)
+        run(100);
+
+        std::size_t count = 1000;
+        while (true)
+        {
+            allocations = 0;
+            PyRef::refcount_ops = 0;
+
+            const auto start = clock::now();
+            run(count);
+            const auto elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+            if (elapsed >= 50e6 || count >= (std::size_t(1) << 30))
+                return { elapsed / count,
+                         static_cast<double>(allocations) / count,
+                         static_cast<double>(PyRef::refcount_ops) / count };
+
+            // aim a bit over the target to avoid another round
+            count = elapsed < 1e6 ? count * 100 : static_cast<std::size_t>(count * 60e6 / elapsed);
+        }
+    }
+
+    /// Benchmark \var name, done with python.hh by \var wrapper and with the C-API by \var baseline
+    template <typename W, typename B>
+    void pair(const std::string& name, W wrapper, B baseline)
+    {
+        results.push_back({ name, measure(wrapper), measure(baseline) });
+    }
+
+    /// Print the results as JSON on stdout (see make_bench.py)
+    inline void report(void)
+    {
+        auto print = [](const Measure& m)
+        {
+            std::printf("{\"ns_per_op\": %.2f, \"allocs_per_op\": %.2f, \"refcount_ops_per_op\": %.2f}",
+                        m.ns_per_op, m.allocs_per_op, m.refcount_ops_per_op);
+        };
+
+        std::printf("[\n");
+        for (std::size_t i = 0; i < results.size(); i++)
+        {
+            const auto& result = results[i];
+
+            std::string name;
+            for (const char c : result.name)
+            {
+                if (c == '"' || c == '\\')
+                    name += '\\';
+                name += c;
+            }
+
+            std::printf("  {\"name\": \"%s\", \"python.hh\": ", name.c_str());
+            print(result.wrapper);
+            std::printf(", \"c-api\": ");
+            print(result.baseline);
+            std::printf(", \"ratio\": %.2f}%s\n", result.wrapper.ns_per_op / result.baseline.ns_per_op,
+                        i + 1 < results.size() ? "," : "");
+        }
+        std::printf("]\n");
+    }
+}
+
+// C++ allocations are counted too (one definition per program, each benchmark is a program)
+void* operator new(std::size_t size)
+{
+    bench::allocations++;
+
+    if (auto ptr = std::malloc(size ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
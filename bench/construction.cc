@@ -0,0 +1,200 @@
+// BENCH: construction of python objects from C++ values and containers
+
+# include <set>
+
+# include "bench.hh"
+
+int main()
+{
+    bench::initialize();
+
+    bench::pair("construction/int",
+        []() { return Python(123456); },
+        []()
+        {
+            auto o = PyLong_FromLong(123456);
+            bench::decref(o);
+        });
+
+    bench::pair("construction/double",
+        []() { return Python(3.14); },
+        []()
+        {
+            auto o = PyFloat_FromDouble(3.14);
+            bench::decref(o);
+        });
+
+    const std::string string = "a string of a few words";
+    bench::pair("construction/string",
+        [&]() { return Python(string); },
+        [&]()
+        {
+            auto o = PyUnicode_FromStringAndSize(string.data(), string.size());
+            bench::decref(o);
+        });
+
+    bench::pair("construction/bytes",
+        [&]() { return Python::bytes(string); },
+        [&]()
+        {
+            auto o = PyBytes_FromStringAndSize(string.data(), string.size());
+            bench::decref(o);
+        });
+
+    std::vector<int> vector(100);
+    for (int i = 0; i < 100; i++)
+        vector[i] = i * 1000;
+
+    bench::pair("construction/vector<int>[100]",
+        [&]() { return Python(vector); },
+        [&]()
+        {
+            auto o = PyList_New(vector.size());
+            for (std::size_t i = 0; i < vector.size(); i++)
+                PyList_SET_ITEM(o, i, PyLong_FromLong(vector[i]));
+            bench::decref(o);
+        });
+
+    const std::list<double> list(vector.begin(), vector.end());
+    bench::pair("construction/list<double>[100]",
+        [&]() { return Python(list); },
+        [&]()
+        {
+            auto o = PyList_New(list.size());
+            Py_ssize_t i = 0;
+            for (const auto item : list)
+                PyList_SET_ITEM(o, i++, PyFloat_FromDouble(item));
+            bench::decref(o);
+        });
+
+    std::array<int, 100> array;
+    std::copy(vector.begin(), vector.end(), array.begin());
+    bench::pair("construction/array<int,100>",
+        [&]() { return Python(array); },
+        [&]()
+        {
+            auto o = PyList_New(array.size());
+            for (std::size_t i = 0; i < array.size(); i++)
+                PyList_SET_ITEM(o, i, PyLong_FromLong(array[i]));
+            bench::decref(o);
+        });
+
+    // python.hh has no set from C++ containers, it goes through a list
+    const std::set<int> set(vector.begin(), vector.end());
+    bench::pair("construction/set<int>[100]",
+        [&]() { return Python::set(Python::list(set)); },
+        [&]()
+        {
+            auto o = PySet_New(nullptr);
+            for (const auto item : set)
+            {
+                auto v = PyLong_FromLong(item);
+                PySet_Add(o, v);
+                bench::decref(v);
+            }
+            bench::decref(o);
+        });
+
+    std::map<std::string, int> map;
+    for (int i = 0; i < 10; i++)
+        map["key" + std::to_string(i)] = i;
+
+    bench::pair("construction/map<string,int>[10]",
+        [&]() { return Python(map); },
+        [&]()
+        {
+            auto o = PyDict_New();
+            for (const auto& [key, value] : map)
+            {
+                auto k = PyUnicode_FromStringAndSize(key.data(), key.size());
+                auto v = PyLong_FromLong(value);
+                PyDict_SetItem(o, k, v);
+                bench::decref(k);
+                bench::decref(v);
+            }
+            bench::decref(o);
+        });
+
+    const std::unordered_map<std::string, int> unordered_map(map.begin(), map.end());
+    bench::pair("construction/unordered_map<string,int>[10]",
+        [&]() { return Python::dict(unordered_map); },
+        [&]()
+        {
+            auto o = PyDict_New();
+            for (const auto& [key, value] : unordered_map)
+            {
+                auto k = PyUnicode_FromStringAndSize(key.data(), key.size());
+                auto v = PyLong_FromLong(value);
+                PyDict_SetItem(o, k, v);
+                bench::decref(k);
+                bench::decref(v);
+            }
+            bench::decref(o);
+        });
+
+    bench::pair("construction/tuple(int,str,double)",
+        []() { return Python::tuple(1, "a", 2.5); },
+        []()
+        {
+            auto o = PyTuple_New(3);
+            PyTuple_SET_ITEM(o, 0, PyLong_FromLong(1));
+            PyTuple_SET_ITEM(o, 1, PyUnicode_FromStringAndSize("a", 1));
+            PyTuple_SET_ITEM(o, 2, PyFloat_FromDouble(2.5));
+            bench::decref(o);
+        });
+
+    const auto tuple = std::make_tuple(1, std::string("a"), 2.5);
+    bench::pair("construction/std::tuple<int,string,double>",
+        [&]() { return Python(tuple); },
+        [&]()
+        {
+            const auto& string = std::get<1>(tuple);
+            auto o = PyTuple_New(3);
+            PyTuple_SET_ITEM(o, 0, PyLong_FromLong(std::get<0>(tuple)));
+            PyTuple_SET_ITEM(o, 1, PyUnicode_FromStringAndSize(string.data(), string.size()));
+            PyTuple_SET_ITEM(o, 2, PyFloat_FromDouble(std::get<2>(tuple)));
+            bench::decref(o);
+        });
+
+    // typed handles: a type check and a reference
+    auto list_object = Python(vector);
+    PyObject* plist = list_object;
+    bench::pair("construction/PyList(list)",
+        [&]() { return PyList(list_object); },
+        [&]()
+        {
+            if (PyList_Check(plist))
+            {
+                bench::incref(plist);
+                bench::decref(plist);
+            }
+        });
+
+    auto dict_object = Python(map);
+    PyObject* pdict = dict_object;
+    bench::pair("construction/PyDict(dict)",
+        [&]() { return PyDict(dict_object); },
+        [&]()
+        {
+            if (PyDict_Check(pdict))
+            {
+                bench::incref(pdict);
+                bench::decref(pdict);
+            }
+        });
+
+    auto str_object = Python(string);
+    PyObject* pstr = str_object;
+    bench::pair("construction/PyStr(str)",
+        [&]() { return PyStr(str_object); },
+        [&]()
+        {
+            if (PyUnicode_Check(pstr))
+            {
+                bench::incref(pstr);
+                bench::decref(pstr);
+            }
+        });
+
+    bench::report();
+}
@@ -0,0 +1,78 @@
+// BENCH: conversions of python objects to C++ values and containers
+
+# include "bench.hh"
+
+int main()
+{
+    bench::initialize();
+
+    auto integer = Python(123456);
+    PyObject* pinteger = integer;
+    bench::pair("conversion/as<long>",
+        [&]() { return integer.as<long>(); },
+        [&]() { return PyLong_AsLong(pinteger); });
+
+    auto real = Python(3.14);
+    PyObject* preal = real;
+    bench::pair("conversion/as<double>",
+        [&]() { return real.as<double>(); },
+        [&]() { return PyFloat_AsDouble(preal); });
+
+    auto string = Python(std::string("a string of a few words"));
+    PyObject* pstring = string;
+    bench::pair("conversion/as<std::string>",
+        [&]() { return string.as<std::string>(); },
+        [&]()
+        {
+            Py_ssize_t size = 0;
+            auto data = PyUnicode_AsUTF8AndSize(pstring, &size);
+            return std::string(data, size);
+        });
+
+    bench::pair("conversion/as_utf8_view",
+        [&]() { return string.as_utf8_view(); },
+        [&]()
+        {
+            Py_ssize_t size = 0;
+            auto data = PyUnicode_AsUTF8AndSize(pstring, &size);
+            return std::string_view(data, size);
+        });
+
+    std::vector<int> values(100);
+    for (int i = 0; i < 100; i++)
+        values[i] = i * 1000;
+
+    auto list = Python(values);
+    PyObject* plist = list;
+    bench::pair("conversion/as<vector<int>>[100]",
+        [&]() { return list.as<std::vector<int>>(); },
+        [&]()
+        {
+            std::vector<int> out;
+            out.reserve(PyList_GET_SIZE(plist));
+            for (Py_ssize_t i = 0; i < PyList_GET_SIZE(plist); i++)
+                out.push_back(PyLong_AsLong(PyList_GET_ITEM(plist, i)));
+            return out;
+        });
+
+    auto dict = Python::dict("first", 1, "second", 2, "third", 3);
+    PyObject* pdict = dict;
+    bench::pair("conversion/as<map<string,int>>[3]",
+        [&]() { return dict.as<std::map<std::string, int>>(); },
+        [&]()
+        {
+            std::map<std::string, int> out;
+            Py_ssize_t pos = 0;
+            PyObject* k = nullptr;
+            PyObject* v = nullptr;
+            while (PyDict_Next(pdict, &pos, &k, &v))
+            {
+                Py_ssize_t size = 0;
+                auto data = PyUnicode_AsUTF8AndSize(k, &size);
+                out.emplace(std::string(data, size), PyLong_AsLong(v));
+            }
+            return out;
+        });
+
+    bench::report();
+}
@@ -0,0 +1,51 @@
+// BENCH: compilation and evaluation of python code
+
+# include "bench.hh"
+
+int main()
+{
+    bench::initialize();
+
+    auto globals = Python::dict();
+    auto locals = Python::dict("x", 21);
+    PyObject* pglobals = globals;
+    PyObject* plocals = locals;
+    PyDict_SetItemString(pglobals, "__builtins__", PyEval_GetBuiltins());
+
+    // the source is compiled once by both (python.hh finds it again in its compile cache)
+    auto compiled = PyRef(Py_CompileString("x * 2", "<string>", Py_eval_input), "x * 2");
+    bench::pair("eval/source",
+        [&]() { return Python::eval("x * 2", Py_eval_input, globals, locals); },
+        [&]()
+        {
+            auto o = PyEval_EvalCode(compiled, pglobals, plocals);
+            bench::decref(o);
+        });
+
+    auto code = Python::compile("x * 2");
+    PyObject* pcode = code;
+    bench::pair("eval/code",
+        [&]() { return Python::eval(code, globals, locals); },
+        [&]()
+        {
+            auto o = PyEval_EvalCode(pcode, pglobals, plocals);
+            bench::decref(o);
+        });
+
+    Python::Context context;
+    context.exec("def double(x):\n    return x * 2");
+
+    auto context_globals = context.globals();
+    PyObject* pcontext_globals = context_globals;
+    auto call = PyRef(Py_CompileString("double(x)", "<string>", Py_eval_input), "double(x)");
+
+    bench::pair("eval/Context.eval",
+        [&]() { return context.eval("double(x)", locals); },
+        [&]()
+        {
+            auto o = PyEval_EvalCode(call, pcontext_globals, plocals);
+            bench::decref(o);
+        });
+
+    bench::report();
+}
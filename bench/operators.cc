@@ -0,0 +1,124 @@
+// BENCH: operators, comparisons and calls
+
+# include "bench.hh"
+
+int main()
+{
+    bench::initialize();
+
+    auto a = Python(1000);
+    auto b = Python(2000);
+    PyObject* pa = a;
+    PyObject* pb = b;
+
+    bench::pair("operator/a + b",
+        [&]() { return a + b; },
+        [&]()
+        {
+            auto o = PyNumber_Add(pa, pb);
+            bench::decref(o);
+        });
+
+    bench::pair("operator/a * b",
+        [&]() { return a * b; },
+        [&]()
+        {
+            auto o = PyNumber_Multiply(pa, pb);
+            bench::decref(o);
+        });
+
+    bench::pair("operator/a += b",
+        [&]()
+        {
+            auto c = a;
+            c += b;
+            return c;
+        },
+        [&]()
+        {
+            bench::incref(pa);
+            auto o = PyNumber_InPlaceAdd(pa, pb);
+            bench::decref(pa);
+            bench::decref(o);
+        });
+
+    bench::pair("comparison/a < b",
+        [&]() { return a < b; },
+        [&]()
+        {
+            auto o = PyObject_RichCompare(pa, pb, Py_LT);
+            bench::decref(o);
+        });
+
+    // calls
+    auto list = Python::list(1, 2, 3, 1, 2, 3);
+    PyObject* plist = list;
+
+    auto builtins = Python::builtins();
+    auto len = Python(builtins["len"_key]);
+    PyObject* plen = len;
+
+    bench::pair("call/len(list)",
+        [&]() { return len(list); },
+        [&]()
+        {
+            auto o = PyObject_CallOneArg(plen, plist);
+            bench::decref(o);
+        });
+
+    auto max = Python(builtins["max"_key]);
+    PyObject* pmax = max;
+    bench::pair("call/max(a, b)",
+        [&]() { return max(a, b); },
+        [&]()
+        {
+            PyObject* args[] = { pa, pb };
+            auto o = PyObject_Vectorcall(pmax, args, 2, nullptr);
+            bench::decref(o);
+        });
+
+    auto one = Python(1);
+    PyObject* pone = one;
+    auto count = PyRef(PyUnicode_InternFromString("count"), "count");
+    bench::pair("call/list.count(1)",
+        [&]() { return list.method("count"_key, one); },
+        [&]()
+        {
+            auto o = PyObject_CallMethodOneArg(plist, count, pone);
+            bench::decref(o);
+        });
+
+    // keyword arguments: int("ff", base=16)
+    auto int_type = Python(builtins["int"_key]);
+    PyObject* pint = int_type;
+    auto args = Python::tuple(std::make_tuple("ff"));
+    auto kwargs = Python::dict("base", 16);
+    PyObject* pargs = args;
+    PyObject* pkwargs = kwargs;
+    bench::pair("call/int(*args, **kwargs)",
+        [&]() { return int_type.call(args, kwargs); },
+        [&]()
+        {
+            auto o = PyObject_Call(pint, pargs, pkwargs);
+            bench::decref(o);
+        });
+
+    bench::pair("call/int(\"ff\", base=16)",
+        [&]() { return int_type.call(Python::tuple(std::make_tuple("ff")), Python::dict("base", 16)); },
+        [&]()
+        {
+            auto a = PyTuple_New(1);
+            PyTuple_SET_ITEM(a, 0, PyUnicode_FromStringAndSize("ff", 2));
+            auto k = PyDict_New();
+            auto v = PyLong_FromLong(16);
+            PyDict_SetItemString(k, "base", v);
+            bench::decref(v);
+
+            auto o = PyObject_Call(pint, a, k);
+            bench::decref(o);
+            bench::decref(k);
+            bench::decref(a);
+        });
+
+    bench::report();
+}
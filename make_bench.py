@@ -0,0 +1,96 @@
+#!/bin/python
+
+# compile and run every bench/*.cc, each one printing its results as JSON
+# usage: make_bench.py [--compare old_report.json] [--threshold 0.1] [names...]
+
+from os import listdir
+from os.path import splitext, join, basename
+from subprocess import Popen, PIPE, check_output
+from sys import stderr as err
+from argparse import ArgumentParser
+from json import loads, load, dump
+from tempfile import TemporaryDirectory
+
+BENCH_DIR = "bench"
+REPORT = "bench_report.json"
+PKG = check_output(("pkg-config", "--cflags", "--libs", "python3-embed")).decode().split()
+MAKE_CMD = ("g++", "-O2", "-DNDEBUG", "-Wall", "-Wextra", "-Werror", "-pedantic", "-std=c++17", \
+            "-I.", *PKG)
+
+parser = ArgumentParser(description = "python.hh microbenchmarks against the C-API")
+parser.add_argument("names", nargs = "*", help = "benchmarks to run (all of %s by default)" %BENCH_DIR)
+parser.add_argument("--compare", help = "previous report, to detect the regressions")
+parser.add_argument("--threshold", type = float, default = 0.1,
+                    help = "relative slowdown reported as a regression (default: 0.1)")
+args = parser.parse_args()
+
+# generate .cc -> binary (in \var directory) with error check
+def make_binary(cc: str, directory: str) -> str:
+    name = join(directory, splitext(basename(cc))[0])
+
+    p = Popen(MAKE_CMD + ("-o", name, cc, "backtrace.cc", *PKG), stderr = PIPE)
+    stderr = p.communicate()[1]
+
+    if p.returncode != 0:
+        print(stderr.decode(), file = err)
+        exit(1)
+
+    return name
+
+# execute binary and parse its results
+def run(binary: str) -> list:
+    p = Popen((binary,), stdout = PIPE, stderr = PIPE)
+    stdout, stderr = p.communicate()
+
+    if p.returncode != 0:
+        print("%s failed:\n%s" %(binary, stderr.decode()), file = err)
+        exit(1)
+
+    return loads(stdout.decode())
+
+names = args.names or sorted(splitext(file)[0] for file in listdir(BENCH_DIR) if file.endswith(".cc"))
+
+# the binaries don't outlive the run
+results = []
+with TemporaryDirectory() as directory:
+    for name in names:
+        results += run(make_binary(join(BENCH_DIR, "%s.cc" %name), directory))
+
+with open(REPORT, 'w') as f:
+    dump(results, f, indent = 2)
+
+print("%-40s %12s %12s %8s %10s %10s" %("benchmark", "python.hh", "c-api", "ratio", "allocs", "refcounts"))
+for result in results:
+    wrapper, baseline = result["python.hh"], result["c-api"]
+    print("%-40s %9.1f ns %9.1f ns %7.2fx %4.1f/%-5.1f %4.1f/%-5.1f" %(result["name"],
+          wrapper["ns_per_op"], baseline["ns_per_op"], result["ratio"],
+          wrapper["allocs_per_op"], baseline["allocs_per_op"],
+          wrapper["refcount_ops_per_op"], baseline["refcount_ops_per_op"]))
+
+if args.compare is None:
+    exit(0)
+
+# regressions of the python.hh side (slower, or more allocations/refcount operations)
+with open(args.compare) as f:
+    previous = { result["name"]: result["python.hh"] for result in load(f) }
+
+regressions = 0
+for result in results:
+    old = previous.get(result["name"])
+    if old is None:
+        continue
+
+    new = result["python.hh"]
+    slowdown = new["ns_per_op"] / old["ns_per_op"] - 1
+
+    if slowdown > args.threshold:
+        print("REGRESSION %s: %.1f ns -> %.1f ns (+%.0f%%)" %(result["name"], old["ns_per_op"], new["ns_per_op"],
+                                                           slowdown * 100))
+        regressions += 1
+
+    for counter in ("allocs_per_op", "refcount_ops_per_op"):
+        if new[counter] > old[counter]:
+            print("REGRESSION %s: %s %.2f -> %.2f" %(result["name"], counter, old[counter], new[counter]))
+            regressions += 1
+
+exit(1 if regressions else 0)
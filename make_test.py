@@ -11,6 +11,8 @@ from bs4 import BeautifulSoup
 
 import pytest_html
 
+# the python is the one of pkg-config, another one is tested with PKG_CONFIG_PATH=<prefix>/lib/pkgconfig
+# (tests/interpreters.cc only exercises the InterpreterPool with python 3.12+)
 TEST_DIR = "tests"
 PKG = check_output(("pkg-config", "--cflags", "--libs", "python3")).decode().split(' ')[:-1]
 MAKE_CMD = ("g++", "-g3", "-Wall", "-Wextra", "-Werror", "-pedantic", "-std=c++17", \
@@ -13,6 +13,13 @@
 
 # include <iostream>
 # include <memory>
+# include <atomic>
+# include <mutex>
+# include <cstddef>
+# include <utility>
+# include <functional>
+# include <algorithm>
+# include <cstring>
 # include <cassert>
 # include <filesystem>
 # include <sstream>
@@ -21,6 +28,21 @@
 # include <vector>
 # include <list>
 # include <map>
+# include <unordered_map>
+# include <optional>
+# include <string_view>
+
+# if __cplusplus >= 202002L
+    # include <span>
+# endif
+
+// per-interpreter GIL (InterpreterPool)
+# if PY_VERSION_HEX >= 0x030C0000
+    # include <thread>
+    # include <future>
+    # include <condition_variable>
+    # include <deque>
+# endif
 
 # include <regex>
 # include <locale>
@@ -39,6 +61,37 @@
 //# define PYDEBUG_CONST
 //# define PYDEBUG_DEST
 
+// Counting is the number of INCREF/DECREF done by the PyRefs of a thread (PyRef::refcount_ops)
+/// Enable counting of INCREF and DECREF (without logging, used by the benchmarks)
+//# define PYDEBUG_COUNT
+
+// Debug names are the C++-side representation of an object (like "sys.stderr")
+// They are only needed by the logs above, so they cost nothing unless enabled
+/// Enable storage and computation of debug names
+//# define PYDEBUG_NAME
+// (PYDEBUG_COUNT logs nothing and doesn't enable them, the benchmarks would measure their cost)
+# if defined(PYDEBUG_INCREF) || defined(PYDEBUG_DECREF) \
+  || defined(PYDEBUG_CONST) || defined(PYDEBUG_DEST)
+    # ifndef PYDEBUG_NAME
+        # define PYDEBUG_NAME
+    # endif
+# endif
+
+// NOTE: [[no_unique_address]] is C++20, GCC and Clang accept it in C++17 as an extension
+//       and MSVC only honors its own attribute (checked by the size of PyRef below)
+# ifdef _MSC_VER
+    # define PY_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+# else
+    # define PY_NO_UNIQUE_ADDRESS [[no_unique_address]]
+# endif
+
+// NOTE: the frames skipped by a backtrace must exist, so they are never inlined
+# ifdef BACKTRACE
+    # define PY_TRACED_FRAME __attribute__((noinline))
+# else
+    # define PY_TRACED_FRAME
+# endif
+
 namespace
 {
     [[maybe_unused]] std::string get_typename(const char* s, int skips = 0)
@@ -79,6 +132,59 @@ namespace
     template <typename T>
     using is_iterable = decltype(is_iterable_type<T>());
 
+    /// Check if the size of \var T is known (std::size)
+    template <typename T, typename = void>
+    struct has_size : std::false_type {};
+
+    template <typename T>
+    struct has_size<T, std::void_t<decltype(std::size(std::declval<const T&>()))>> : std::true_type {};
+
+    /// Check if \var T is an instance of the template \var Tmpl (like std::vector<int>)
+    template <typename T, template <typename...> class Tmpl>
+    struct is_instance : std::false_type {};
+
+    template <template <typename...> class Tmpl, typename ...Args>
+    struct is_instance<Tmpl<Args...>, Tmpl> : std::true_type {};
+
+    template <typename T>
+    struct is_std_array : std::false_type {};
+
+    template <typename T, std::size_t N>
+    struct is_std_array<std::array<T, N>> : std::true_type {};
+
+    /// Format of \var T in the buffer protocol (same syntax as the struct module)
+    template <typename T>
+    constexpr const char* buffer_format(void)
+    {
+        using B = typename std::remove_cv<T>::type;
+
+        if constexpr(std::is_same<B, bool>::value)                  return "?";
+        // byte-likes
+        else if constexpr(std::is_same<B, char>::value
+                       || std::is_same<B, unsigned char>::value
+                       || std::is_same<B, std::byte>::value)        return "B";
+        else if constexpr(std::is_same<B, signed char>::value)      return "b";
+        // signed
+        else if constexpr(std::is_same<B, short>::value)            return "h";
+        else if constexpr(std::is_same<B, int>::value)              return "i";
+        else if constexpr(std::is_same<B, long>::value)             return "l";
+        else if constexpr(std::is_same<B, long long>::value)        return "q";
+        // unsigned
+        else if constexpr(std::is_same<B, unsigned short>::value)   return "H";
+        else if constexpr(std::is_same<B, unsigned int>::value)     return "I";
+        else if constexpr(std::is_same<B, unsigned long>::value)    return "L";
+        else if constexpr(std::is_same<B, unsigned long long>::value) return "Q";
+        // floatant
+        else if constexpr(std::is_same<B, float>::value)            return "f";
+        else if constexpr(std::is_same<B, double>::value)           return "d";
+        else
+        {
+            // dependent false, any other type (long double, wchar_t, char16_t...) fails to compile
+            static_assert(sizeof(T) == 0, "type not supported by the buffer protocol");
+            return nullptr;
+        }
+    }
+
     std::string escape(const std::string str)
     {
         std::string ret(str);
@@ -101,51 +207,136 @@ namespace
     // disabled as it litteraly *doubles* the duration of the tests
     // const auto kwargs_regex = std::regex("\"([^\"]*)\": ");
 
-    // convert from char_t -> char
+    // convert from char_t -> char (UTF-16 with surrogate pairs for 2 bytes characters)
     template <typename char_t>
-    std::wstring_convert<std::codecvt_utf8<char_t>, char_t> converter;
+    std::wstring_convert<typename std::conditional<sizeof(char_t) == 2, std::codecvt_utf8_utf16<char_t>,
+                                                   std::codecvt_utf8<char_t>>::type, char_t> converter;
+
 }
 
+/// Debug name policy, only storing (and computing) the name if \var enabled
+template <bool enabled>
+class BasicPyName;
+
+template <>
+class BasicPyName<true>
+{
+public:
+    static constexpr bool enabled = true;
+
+    BasicPyName(void)
+        : name_("NULL")
+    {}
+
+    BasicPyName(const char* name)
+        : name_(escape(name))
+    {}
+
+    BasicPyName(const std::string& name)
+        : name_(escape(name))
+    {}
+
+    /// Lazy form, \var thunk is only called if names are enabled
+    template <typename F, typename = decltype(std::string(std::declval<F&>()()))>
+    BasicPyName(F&& thunk)
+        : name_(escape(thunk()))
+    {}
+
+    const std::string& str(void) const
+    {
+        return name_;
+    }
+
+private:
+    std::string name_;
+};
+
+template <>
+class BasicPyName<false>
+{
+public:
+    static constexpr bool enabled = false;
+
+    BasicPyName(void)
+    {}
+
+    BasicPyName(const char*)
+    {}
+
+    BasicPyName(const std::string&)
+    {}
+
+    template <typename F, typename = decltype(std::string(std::declval<F&>()()))>
+    BasicPyName(F&&)
+    {}
+
+    std::string str(void) const
+    {
+        return std::string();
+    }
+};
+
+# ifdef PYDEBUG_NAME
+using PyName = BasicPyName<true>;
+# else
+using PyName = BasicPyName<false>;
+# endif
+
+/// Build a debug name from \var EXPR, only evaluated if names are enabled
+# define PYNAME(EXPR) PyName([&]() { return std::string(EXPR); })
+
 /// Wrapper around PyObject* taking care of INCREF/DECREF and debug
 struct PyRef
 {
-    PyRef(PyObject* ptr, const std::string& name, const bool borrowed = false)
-        : ptr(ptr), name(escape(name))
-    {
-        if (ptr == nullptr)
-            return;
+    /// Tag to take ownership of a new reference (default)
+    struct Steal {};
+    /// Tag to share a borrowed reference (INCREF)
+    struct Borrow {};
+
+    static constexpr Steal steal{};
+    static constexpr Borrow borrow{};
 
+    PyRef(PyObject* ptr, PyName name, Steal = steal)
+        : ptr(ptr), name(std::move(name))
+    {
         # ifdef PYDEBUG_CONST
-        std::cout << "Construction of " << this->name << std::endl;
+        if (ptr)
+            std::cout << "Construction of " << this->name.str() << std::endl;
         # endif
+    }
 
+    PyRef(PyObject* ptr, PyName name, Borrow)
+        : PyRef(ptr, std::move(name), steal)
+    {
         // increase life duration to outlive it owner
-        if (borrowed)
-            Py_INCREF(ptr);
+        incref();
     }
 
     PyRef(void)
-        : ptr(nullptr), name("NULL")
+        : ptr(nullptr)
     {}
 
     PyRef(const PyRef& o)
+        : ptr(o.ptr), name(o.name)
     {
-        *this = o;
+        incref();
     }
 
+    /// Move constructor, the ownership is transfered (no INCREF/DECREF)
+    PyRef(PyRef&& o) noexcept
+        : ptr(std::exchange(o.ptr, nullptr)), name(std::move(o.name))
+    {}
+
     PyRef& operator=(const PyRef& o)
     {
-        ptr     = o.ptr;
-        name    = o.name;
-
-        if (ptr == nullptr)
-            return *this;
-
-        Py_INCREF(ptr);
+        // copy first to handle self assignment
+        return *this = PyRef(o);
+    }
 
-        # ifdef PYDEBUG_INCREF
-        std::cout << "Incref of " << name << std::endl;
-        # endif
+    PyRef& operator=(PyRef&& o) noexcept
+    {
+        std::swap(ptr, o.ptr);
+        std::swap(name, o.name);
 
         return *this;
     }
@@ -161,6 +352,12 @@ struct PyRef
         return ptr;
     }
 
+    /// Give up the ownership of the reference (to pass it to a function stealing it)
+    PyObject* release(void)
+    {
+        return std::exchange(ptr, nullptr);
+    }
+
     // NOTE: destruction won't work on borrowed reference with owner still alive
     //       (it will not be logged) like a module's dict or a container's item
     ~PyRef()
@@ -168,23 +365,57 @@ struct PyRef
         if (ptr == nullptr)
             return;
 
+        assert(PyGILState_Check() && "python object released without holding the GIL");
+
         # ifdef PYDEBUG_DECREF
-            std::cout << "Decref of " << name
+            std::cout << "Decref of " << name.str()
                       << " (" << (ptr->ob_refcnt - 1) << " instances remaining)" << std::endl;
         # endif
 
         # ifdef PYDEBUG_DEST
         if (ptr->ob_refcnt == 1)
-            std::cout << "Destruction of " << name << std::endl;
+            std::cout << "Destruction of " << name.str() << std::endl;
+        # endif
+
+        # ifdef PYDEBUG_COUNT
+            refcount_ops++;
         # endif
 
         Py_DECREF(ptr);
     }
 
     PyObject* ptr;
-    std::string name;
+    PY_NO_UNIQUE_ADDRESS PyName name;
+
+    # ifdef PYDEBUG_COUNT
+    /// Number of INCREF/DECREF done by the PyRefs of the current thread
+    static inline thread_local std::size_t refcount_ops = 0;
+    # endif
+
+private:
+    void incref(void)
+    {
+        if (ptr == nullptr)
+            return;
+
+        assert(PyGILState_Check() && "python object shared without holding the GIL");
+
+        Py_INCREF(ptr);
+
+        # ifdef PYDEBUG_INCREF
+        std::cout << "Incref of " << name.str() << std::endl;
+        # endif
+
+        # ifdef PYDEBUG_COUNT
+            refcount_ops++;
+        # endif
+    }
 };
 
+// without debug names, a PyRef is nothing more than a pointer
+static_assert(PyName::enabled || sizeof(PyRef) == sizeof(PyObject*),
+              "the compiler must support [[no_unique_address]] (see PY_NO_UNIQUE_ADDRESS)");
+
 /// Wrapper around PyRef taking care of all the functions and the logic behind
 class Python
 {
@@ -201,1408 +432,4526 @@ public:
         Sequence,   // list, array
     };
 
-    /// Error class to indicate any normal error (look at the trace for more info)
-    class PythonError : std::exception
-    { };
+    /// Tag for strings known to be 7-bit ASCII (no UTF-8 decoding)
+    struct Ascii {};
+    /// Tag to intern the string (see PyUnicode_InternInPlace)
+    struct Interned {};
 
-    /// Error class to indicate the end of a "for ... in ..." iteration
-    class StopIteration : std::exception
-    { };
+    static constexpr Ascii ascii{};
+    static constexpr Interned interned{};
 
-    // FIXME: refactor the whole class
-    /// Intermediary class to recongnize starred expressions
-    template <typename T>
-    class Starred
+    enum class DictPart
+    {
+        Keys,
+        Values,
+        Items,      // (key, value) pairs
+    };
+
+    // WARNING: the dict must not be resized during the iteration (like in python)
+    /// View over the keys, values or items of a dict, walked in place with PyDict_Next
+    /// No python object is created, the items are borrowed from the dict
+    template <DictPart part>
+    class DictView
     {
     public:
-        Starred(T&& ref)
-            : ref_(ref)
+        class Iterator
         {
-            static_assert(is_starred<0, Starred<T>>::value);
-        }
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = typename std::conditional<part == DictPart::Items,
+                                                         std::pair<Python, Python>, Python>::type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            /// End of any iteration
+            Iterator(void)
+            {}
+
+            explicit Iterator(PyObject* dict)
+                : dict_(dict)
+            {
+                ++*this;
+            }
 
-        Starred(T& ref)
-            : ref_(ref)
+            /// Python for keys and values, std::pair<Python, Python> for items
+            value_type operator*() const
+            {
+                if constexpr(part == DictPart::Keys)
+                    return Python(key_, "key", PyRef::borrow);
+                else if constexpr(part == DictPart::Values)
+                    return Python(value_, "value", PyRef::borrow);
+                else
+                    return { Python(key_, "key", PyRef::borrow), Python(value_, "value", PyRef::borrow) };
+            }
+
+            Iterator& operator++()
+            {
+                if (dict_ && PyDict_Next(dict_, &pos_, &key_, &value_) == 0)
+                    dict_ = nullptr;
+
+                return *this;
+            }
+
+            // only the comparison with the end is meaningful
+            bool operator==(const Iterator& o) const
+            {
+                return (dict_ == nullptr) == (o.dict_ == nullptr);
+            }
+
+            bool operator!=(const Iterator& o) const
+            {
+                return !(*this == o);
+            }
+
+        private:
+            PyObject* dict_ = nullptr;
+            Py_ssize_t pos_ = 0;
+            PyObject* key_ = nullptr;
+            PyObject* value_ = nullptr;
+        };
+
+        explicit DictView(const PyRef& dict)
+            : dict_(dict)
         {
-            static_assert(is_starred<0, Starred<T>>::value);
+            assert(PyDict_Check(dict_.ptr));
         }
 
-        // For argument expansion (like tuple(1, 2, *args, 3))
-        operator Python()
+        Iterator begin(void) const
         {
-            Python ref = ref_;
+            return Iterator(dict_.ptr);
+        }
 
-            assert(static_cast<PyObject*>(ref) != nullptr);
+        Iterator end(void) const
+        {
+            return Iterator();
+        }
 
-            if (PySequence_Check(ref))
-                return ref;
-            else if (PyDict_Check(ref))
-                return ref_.keys();
-            else
-                throw std::invalid_argument("starred expression must be an iterable");
+        Py_ssize_t size(void) const
+        {
+            return PyDict_GET_SIZE(dict_.ptr);
         }
 
-        auto operator=(Python o)
+        /// New list of the keys, values or (key, value) tuples (like dict.keys() in python 2)
+        Python list(void) const
         {
-            return (ref_ = o);
+            PyObject* ptr;
+            if constexpr(part == DictPart::Keys)
+                ptr = PyDict_Keys(dict_);
+            else if constexpr(part == DictPart::Values)
+                ptr = PyDict_Values(dict_);
+            else
+                ptr = PyDict_Items(dict_);
+            err("dict view");
+
+            return Python(ptr, PYNAME(dict_.name.str() + (part == DictPart::Keys ? ".keys()"
+                                                       : part == DictPart::Values ? ".values()"
+                                                       : ".items()")));
         }
 
     private:
-        T& ref_;
+        PyRef dict_;
     };
 
-private:
-    static void initialize()
+    // NOTE: the python objects require the GIL, detach the error to use it without
+    /// Error raised by python, holding the exception (type, value and traceback)
+    /// The message is only formatted when asked for (what)
+    class PythonError : public std::exception
     {
-        if (initialized_ == false)
+    public:
+        /// Take the current python error (the error indicator is cleared)
+        explicit PythonError(const char* func)
+            : func_(func)
         {
-            Py_Initialize();
-            initialized_ = true;
+            # if PY_VERSION_HEX >= 0x030C0000
+                value_ = PyRef(PyErr_GetRaisedException(), "exception");
+                if (value_)
+                {
+                    type_ = PyRef(reinterpret_cast<PyObject*>(Py_TYPE(value_.ptr)), "type", PyRef::borrow);
+                    traceback_ = PyRef(PyException_GetTraceback(value_), "traceback");
+                }
+            # else
+                PyObject* type;
+                PyObject* value;
+                PyObject* traceback;
+                PyErr_Fetch(&type, &value, &traceback);
+                PyErr_NormalizeException(&type, &value, &traceback);
+                if (traceback)
+                    PyException_SetTraceback(value, traceback);
+
+                type_ = PyRef(type, "type");
+                value_ = PyRef(value, "exception");
+                traceback_ = PyRef(traceback, "traceback");
+            # endif
         }
-    }
-
-    static void err(const char* func)
-    {
-        if (mute_error)
-            return;
 
-        if (PyErr_Occurred())
+        // the python objects are copied and released holding the GIL, so that an error can be handled
+        // after leaving the GIL scope it was raised in (like the one of a GILAcquire)
+        PythonError(const PythonError& o)
+            : std::exception(o), func_(o.func_), message_(o.message_)
         {
-            if (finally_func)
-                finally_func();
+            HoldGIL gil(o.type_ || o.value_ || o.traceback_);
 
-            std::cerr << "\nIn function \"" << func << "\":" << std::endl;
-            PyErr_Print();
-            std::cerr << std::endl;
+            type_ = o.type_;
+            value_ = o.value_;
+            traceback_ = o.traceback_;
 
             # ifdef BACKTRACE
-                // skip "err" trace
-                backtrace(1);
+                trace_ = o.trace_;
             # endif
-
-            throw PythonError();
         }
-    }
 
-    template <typename T>
-    static std::string to_string(const T t)
-    {
-        // char-likes
-        if constexpr(std::is_same<T, char>::value || std::is_same<T, wchar_t>::value
-                  || std::is_same<T, char16_t>::value || std::is_same<T, char32_t>::value)
-            return to_string(std::basic_string<T>(1, t));
-        // numbers
-        else
-        {
-            std::stringstream ss;
-            ss << t;
+        PythonError(PythonError&&) noexcept = default;
+        PythonError& operator=(const PythonError&) = delete;
+        PythonError& operator=(PythonError&&) = delete;
 
-            return ss.str();
-        }
-    }
+        ~PythonError()
+        {
+            if (type_ == false && value_ == false && traceback_ == false)
+                return;
 
-    // string-likes
-    static std::string to_string(const std::string& s)
-        { return s; }
-    template <typename char_t>
-    static std::string to_string(const std::basic_string<char_t>& s)
-        { return converter<char_t>.to_bytes(s); }
-    template <typename char_t>
-    static std::string to_string(const char_t* s)
-        { return to_string(std::basic_string<char_t>(s)); }
+            // the interpreter is gone with its objects
+            if (Py_IsInitialized() == false)
+            {
+                type_.release();
+                value_.release();
+                traceback_.release();
+                return;
+            }
 
-    // misc
-    static std::string to_string(const PyRef& s)
-        { return s.name; }
-    static std::string to_string(Python& s)
-        { return s.name(); }
-    static std::string to_string(std::nullptr_t)
-        { return "NULL"; }
-    static std::string to_string(const std::filesystem::path& s)
-        { return s.string(); }
+            HoldGIL gil(true);
 
-    /// Wrapper around PyRef, taking a key, used to access an element
-    template <typename key_t>
-    class PyIndexProxy
-    {
-        /// Force convertion to Python (parent class)
-        Python parent()
-        {
-            return *this;
+            type_ = PyRef();
+            value_ = PyRef();
+            traceback_ = PyRef();
         }
 
-    public:
-        PyIndexProxy(const PyRef& object, const Type type, const key_t& key)
-            : object_(object), type_(type), key_(key)
+        /// Check if the exception is an instance of \var type (like PyExc_KeyError)
+        bool matches(PyObject* type) const
         {
-            // restrict types (until constraints in C++20)
-            static_assert(std::is_same<key_t, std::string>::value
-                       || std::is_same<key_t, char*>::value
-                       || std::is_convertible<key_t, PyObject*>::value
-                       || std::is_convertible<key_t, int>::value);
+            return type_ && PyErr_GivenExceptionMatches(type_, type);
         }
 
-        PyIndexProxy(const PyIndexProxy<key_t>& proxy)
-            : PyIndexProxy(proxy.object_, proxy.type_, proxy.key_)
-        {}
-
-        operator PyObject*()
+        /// "function: Type: message", formatted on first call
+        const char* what() const noexcept override
         {
-            assert(object_.ptr != nullptr);
+            if (message_.empty())
+                message_ = format();
 
-            PyObject* ret = nullptr;
+            return message_.c_str();
+        }
 
-            switch (type_)
+        /// Print the exception and its traceback (like python would)
+        void print(void) const
+        {
+            if (type_)
             {
-                case Type::Object:  ret = PyObject_GetAttr(object_, Python(key_)); break;
-                case Type::Dict:
-                case Type::Sequence:ret = PyObject_GetItem(object_, Python(key_)); break;
+                HoldGIL gil(true);
+                PyErr_Display(type_, value_, traceback_);
             }
-            err("assign");
 
-            return ret;
+            # ifdef BACKTRACE
+                std::cerr << "C++ traceback (most recent call first):" << std::endl;
+                trace_.print();
+            # endif
         }
 
-        // WARNING: as it's a lazy getter, you need to force convertion if you want to keep the object
-        /// Implicit convertion to Python
-        operator Python()
+        # ifdef BACKTRACE
+        /// Native stack where the error was raised (symbolized on first use)
+        const StackTrace& trace(void) const
         {
-            PyObject* ret = *this;
-
-            if (type_ == Type::Object)
-                return Python(ret, object_.name + "." + to_string(key_), true);
-            else if constexpr(std::is_same<key_t, Python>::value)
-                return Python(ret, object_.name + "[" + key_.name() + "]");
-            else if constexpr(std::is_convertible<key_t, std::string>::value)
-                return Python(ret, object_.name + "[\"" + to_string(key_) + "\"]", true);
-            else
-                return Python(ret, object_.name + "[" + to_string(key_) + "]", true);
+            return trace_;
         }
+        # endif
 
-        auto& operator=(PyObject* object)
+        /// Raise the exception back in python (to return it from a C callback)
+        void restore(void)
         {
-            assert(object_.ptr != nullptr);
+            if (type_ == false)
+                return;
+
+            # if PY_VERSION_HEX >= 0x030C0000
+                type_ = PyRef();
+                traceback_ = PyRef();
+                PyErr_SetRaisedException(value_.release());
+            # else
+                PyErr_Restore(type_.release(), value_.release(), traceback_.release());
+            # endif
+        }
 
-            switch (type_)
-            {
-                case Type::Object:  PyObject_SetAttr(object_, Python(key_), object); break;
-                case Type::Dict:
-                case Type::Sequence:PyObject_SetItem(object_, Python(key_), object); break;
-            }
-            err("assign");
+        /// Format the message and drop the python objects (to outlive the interpreter or the GIL)
+        void detach(void)
+        {
+            what();
 
-            return *this;
+            type_ = PyRef();
+            value_ = PyRef();
+            traceback_ = PyRef();
         }
 
-        auto& operator=(Python object)
+        /// Python exception (invalid once restored or detached)
+        Python value(void) const
         {
-            // explicit convertion to avoid looping on itself
-            return operator=(static_cast<PyObject*>(object));
+            return Python(value_.ptr, value_.name, PyRef::borrow);
         }
 
-        // FIXME: ambiguous situations, risk of error
-        // auto proxy = PyIndexProxy()  -> assignation
+    private:
+        std::string format(void) const
+        {
+            std::string message = std::string(func_) + ": ";
+            if (type_ == false)
+                return message + "unknown error";
+
+            message += reinterpret_cast<PyTypeObject*>(type_.ptr)->tp_name;
+
+            HoldGIL gil(true);
+            auto str = PyObject_Str(value_);
+            auto utf8 = str ? PyUnicode_AsUTF8(str) : nullptr;
+            if (utf8 && *utf8)
+                message += std::string(": ") + utf8;
+
+            Py_XDECREF(str);
+            // formatting errors don't matter
+            PyErr_Clear();
+
+            return message;
+        }
+
+        /// Take the GIL if \var needed and the current thread doesn't hold any (nor is being finalized)
+        class HoldGIL
+        {
+        public:
+            explicit HoldGIL(const bool needed)
+                : taken_(needed && Py_IsInitialized() && _PyThreadState_UncheckedGet() == nullptr)
+            {
+                if (taken_)
+                    state_ = PyGILState_Ensure();
+            }
+
+            HoldGIL(const HoldGIL&) = delete;
+            HoldGIL& operator=(const HoldGIL&) = delete;
+
+            ~HoldGIL()
+            {
+                if (taken_)
+                    PyGILState_Release(state_);
+            }
+
+        private:
+            const bool taken_;
+            PyGILState_STATE state_ = PyGILState_UNLOCKED;
+        };
+
+        const char* func_;
+        PyRef type_;
+        PyRef value_;
+        PyRef traceback_;
+        mutable std::string message_;
+
+        # ifdef BACKTRACE
+        // captured once, by raise
+        StackTrace trace_{StackTrace::empty};
+
+        friend Python;
+        # endif
+    };
+
+    // the python exceptions worth a dedicated catch, thrown by err
+    # define PYTHON_ERROR(NAME)                     \
+    class NAME : public PythonError                 \
+    {                                               \
+    public:                                         \
+        explicit NAME(PythonError&& error)          \
+            : PythonError(std::move(error))         \
+        {}                                          \
+                                                    \
+        static PyObject* type(void)                 \
+        {                                           \
+            return PyExc_##NAME;                    \
+        }                                           \
+    };
+    PYTHON_ERROR(KeyError)
+    PYTHON_ERROR(IndexError)
+    PYTHON_ERROR(AttributeError)
+    PYTHON_ERROR(ImportError)
+    PYTHON_ERROR(ValueError)
+    PYTHON_ERROR(TypeError)
+    # undef PYTHON_ERROR
+
+    /// Error class to indicate the end of a "for ... in ..." iteration
+    class StopIteration : std::exception
+    { };
+
+    /// Interned python string, used as a key for item and attribute lookups
+    /// The hash is computed once, and attribute lookups become pointer comparisons
+    class Key
+    {
+        // only string literals have an address that is theirs for the whole program
+        friend class Python;
+        friend Key operator""_key(const char* str, std::size_t size);
+
+        /// Key from a string literal (see _key), interned once for the whole program
+        /// WARNING: \var literal must live as long as the program, its address is the cache key
+        Key(const char* literal, const std::size_t size)
+        {
+            initialize();
+
+            auto& ref = cache_->literal_keys[literal];
+            if (ref == false)
+                ref = intern(literal, size);
+
+            ref_ = ref;
+        }
+
+    public:
+        /// Key from any string, interned at each construction (keep the key around)
+        explicit Key(const std::string& str)
+            : ref_(intern(str.c_str(), str.size()))
+        {}
+
+        operator PyObject*() const
+        {
+            return ref_;
+        }
+
+        /// Content of the key
+        std::string str(void) const
+        {
+            // empty when the interning failed (with muted errors)
+            const char* str = ref_ ? PyUnicode_AsUTF8(ref_) : nullptr;
+            return str ? str : std::string();
+        }
+
+    private:
+        static PyRef intern(const char* str, const std::size_t size)
+        {
+            initialize();
+
+            auto ptr = PyUnicode_FromStringAndSize(str, size);
+            err("key");
+
+            PyUnicode_InternInPlace(&ptr);
+
+            return PyRef(ptr, PYNAME(std::string(str, size)));
+        }
+
+        PyRef ref_;
+    };
+
+    // FIXME: refactor the whole class
+    /// Intermediary class to recongnize starred expressions
+    template <typename T>
+    class Starred
+    {
+    public:
+        Starred(T&& ref)
+            : ref_(ref)
+        {
+            static_assert(is_starred<0, Starred<T>>::value);
+        }
+
+        Starred(T& ref)
+            : ref_(ref)
+        {
+            static_assert(is_starred<0, Starred<T>>::value);
+        }
+
+        // For argument expansion (like tuple(1, 2, *args, 3))
+        operator Python()
+        {
+            Python ref = ref_;
+
+            assert(static_cast<PyObject*>(ref) != nullptr);
+
+            if (PySequence_Check(ref))
+                return ref;
+            else if (PyDict_Check(ref))
+                return ref_.keys();
+            else
+                throw std::invalid_argument("starred expression must be an iterable");
+        }
+
+        auto operator=(Python o)
+        {
+            return (ref_ = o);
+        }
+
+    private:
+        T& ref_;
+    };
+
+    // NOTE: Py_Initialize gives the GIL to the initializing thread (usually the main one),
+    //       which needs to release it (with GILRelease) before other threads can acquire it
+    //       If a GILAcquire initializes python, the GIL is released right after, so every
+    //       thread (the main one included) must then use GILAcquire
+    /// Hold the GIL during its lifetime (from any thread, even ones not created by Python)
+    class GILAcquire
+    {
+    public:
+        GILAcquire(void)
+            : state_((initialize(true), PyGILState_Ensure()))
+        {}
+
+        GILAcquire(const GILAcquire&) = delete;
+        GILAcquire& operator=(const GILAcquire&) = delete;
+
+        ~GILAcquire()
+        {
+            PyGILState_Release(state_);
+        }
+
+    private:
+        PyGILState_STATE state_;
+    };
+
+    /// Release the GIL during its lifetime (around long native computations)
+    /// WARNING: no python object can be used (nor destroyed) in the meantime
+    class GILRelease
+    {
+    public:
+        GILRelease(void)
+            : state_((initialize(), PyEval_SaveThread()))
+        {}
+
+        GILRelease(const GILRelease&) = delete;
+        GILRelease& operator=(const GILRelease&) = delete;
+
+        ~GILRelease()
+        {
+            PyEval_RestoreThread(state_);
+        }
+
+    private:
+        PyThreadState* state_;
+    };
+
+    # if PY_VERSION_HEX >= 0x030C0000
+    // NOTE: objects can't be shared between interpreters, tasks must only return C++ values
+    //       the interpreters may need the main GIL (some imports), release it while waiting
+    /// Sub-interpreters with their own GIL, each one pinned to a worker thread
+    /// Python code submitted to different workers runs in parallel
+    class InterpreterPool
+    {
+    public:
+        explicit InterpreterPool(const std::size_t count = std::thread::hardware_concurrency())
+        {
+            initialize();
+
+            // the workers need the main GIL to create their interpreter
+            MainGILRelease release;
+
+            std::vector<std::future<void>> ready;
+            for (std::size_t i = 0; i < std::max<std::size_t>(count, 1); i++)
+            {
+                std::promise<void> promise;
+                ready.push_back(promise.get_future());
+                workers_.emplace_back(&InterpreterPool::work, this, std::move(promise));
+            }
+
+            try
+            {
+                // rethrow the first creation failure
+                for (auto& future : ready)
+                    future.get();
+            }
+            catch (...)
+            {
+                stop();
+                throw;
+            }
+        }
+
+        InterpreterPool(const InterpreterPool&) = delete;
+        InterpreterPool& operator=(const InterpreterPool&) = delete;
+
+        ~InterpreterPool()
+        {
+            // the queued tasks may still need the main GIL
+            MainGILRelease release;
+            stop();
+        }
+
+        /// Number of interpreters (and worker threads)
+        std::size_t size(void) const
+        {
+            return workers_.size();
+        }
+
+        /// Run \var func in the first available interpreter
+        template <typename F>
+        auto submit(F&& func)
+        {
+            using R = std::invoke_result_t<std::decay_t<F>>;
+
+            // the errors must not keep objects of the interpreter
+            auto task = std::make_shared<std::packaged_task<R()>>(
+                [func = std::forward<F>(func)]() mutable -> R
+                {
+                    try
+                    {
+                        return func();
+                    }
+                    catch (PythonError& e)
+                    {
+                        e.detach();
+                        throw;
+                    }
+                });
+            auto future = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                tasks_.emplace_back([task]() { (*task)(); });
+            }
+            condition_.notify_one();
+
+            return future;
+        }
+
+    private:
+        // NOTE: PyGILState_Check is disabled once sub-interpreters exist
+        /// Release the main GIL if the current thread holds it
+        class MainGILRelease
+        {
+        public:
+            MainGILRelease(void)
+            {
+                auto current = _PyThreadState_UncheckedGet();
+                if (current && PyThreadState_GetInterpreter(current) == PyInterpreterState_Main())
+                    state_ = PyEval_SaveThread();
+            }
+
+            MainGILRelease(const MainGILRelease&) = delete;
+            MainGILRelease& operator=(const MainGILRelease&) = delete;
+
+            ~MainGILRelease()
+            {
+                if (state_)
+                    PyEval_RestoreThread(state_);
+            }
+
+        private:
+            PyThreadState* state_ = nullptr;
+        };
+
+        /// Let the workers finish the queued tasks and end their interpreter
+        void stop(void)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stop_ = true;
+            }
+            condition_.notify_all();
+
+            for (auto& worker : workers_)
+                worker.join();
+        }
+
+        void work(std::promise<void> ready)
+        {
+            // Py_NewInterpreterFromConfig must be called from the main interpreter,
+            // it releases the main GIL and returns holding the new one
+            auto main = PyThreadState_New(PyInterpreterState_Main());
+            PyEval_RestoreThread(main);
+
+            PyInterpreterConfig config = {};
+            config.check_multi_interp_extensions = 1;
+            config.gil = PyInterpreterConfig_OWN_GIL;
+
+            PyThreadState* created = nullptr;
+            auto status = Py_NewInterpreterFromConfig(&created, &config);
+            // (on failure, the main thread state is still the current one)
+            if (PyStatus_Exception(status) == false)
+            {
+                PyEval_SaveThread();
+                PyEval_RestoreThread(main);
+            }
+
+            // the main thread state is bound to this thread for PyGILState_*,
+            // it must be gone before the interpreter runs anything
+            PyThreadState_Clear(main);
+            PyThreadState_DeleteCurrent();
+
+            if (PyStatus_Exception(status))
+            {
+                ready.set_exception(std::make_exception_ptr(std::runtime_error(
+                    status.err_msg ? status.err_msg : "cannot create a sub-interpreter")));
+                return;
+            }
+
+            // thread state bound to this thread in place of the main one
+            auto state = PyThreadState_New(PyThreadState_GetInterpreter(created));
+            PyEval_RestoreThread(state);
+            PyThreadState_Clear(created);
+            PyThreadState_Delete(created);
+
+            InterpreterCache cache;
+            cache_ = &cache;
+            ready.set_value();
+
+            while (true)
+            {
+                std::function<void()> task;
+
+                PyEval_SaveThread();
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    condition_.wait(lock, [this]() { return stop_ || tasks_.empty() == false; });
+
+                    if (tasks_.empty() == false)
+                    {
+                        task = std::move(tasks_.front());
+                        tasks_.pop_front();
+                    }
+                }
+                PyEval_RestoreThread(state);
+
+                if (task == nullptr)
+                    break;
+
+                task();
+            }
+
+            // the cached objects belong to the interpreter
+            cache = InterpreterCache();
+            cache_ = &main_cache_;
+
+            Py_EndInterpreter(state);
+        }
+
+        std::vector<std::thread> workers_;
+        std::deque<std::function<void()>> tasks_;
+        std::mutex mutex_;
+        std::condition_variable condition_;
+        bool stop_ = false;
+    };
+    # endif
+
+private:
+    /// Initialize python once, the initializing thread holding the GIL unless \var release
+    static void initialize(const bool release = false)
+    {
+        // no lock once initialized
+        if (initialized_.load(std::memory_order_acquire))
+            return;
+
+        std::lock_guard<std::mutex> lock(initialize_mutex_);
+        if (initialized_.load(std::memory_order_relaxed) == false)
+        {
+            Py_Initialize();
+
+            // the GIL would never be released by the matching PyGILState_Release
+            if (release)
+                init_state_ = PyEval_SaveThread();
+
+            initialized_.store(true, std::memory_order_release);
+        }
+    }
+
+    PY_TRACED_FRAME static void err(const char* func)
+    {
+        if (mute_error)
+            return;
+
+        if (PyErr_Occurred())
+        {
+            if (finally_func)
+                finally_func();
+
+            raise(PythonError(func));
+        }
+    }
+
+    /// Throw \var error as its most specific class
+    [[noreturn]] PY_TRACED_FRAME static void raise(PythonError&& error)
+    {
+        # ifdef BACKTRACE
+            // skip "raise" and "err" traces
+            error.trace_ = StackTrace(2);
+        # endif
+
+        // subclasses first (ModuleNotFoundError is an ImportError)
+        if (error.matches(PyExc_KeyError))
+            throw KeyError(std::move(error));
+        if (error.matches(PyExc_IndexError))
+            throw IndexError(std::move(error));
+        if (error.matches(PyExc_AttributeError))
+            throw AttributeError(std::move(error));
+        if (error.matches(PyExc_ImportError))
+            throw ImportError(std::move(error));
+        if (error.matches(PyExc_ValueError))
+            throw ValueError(std::move(error));
+        if (error.matches(PyExc_TypeError))
+            throw TypeError(std::move(error));
+
+        throw std::move(error);
+    }
+
+    template <typename T>
+    static std::string to_string(const T t)
+    {
+        // char-likes
+        if constexpr(std::is_same<T, char>::value || std::is_same<T, wchar_t>::value
+                  || std::is_same<T, char16_t>::value || std::is_same<T, char32_t>::value)
+            return to_string(std::basic_string<T>(1, t));
+        // numbers
+        else
+        {
+            std::stringstream ss;
+            ss << t;
+
+            return ss.str();
+        }
+    }
+
+    // string-likes
+    static std::string to_string(const std::string& s)
+        { return s; }
+    template <typename char_t>
+    static std::string to_string(const std::basic_string<char_t>& s)
+        { return converter<char_t>.to_bytes(s); }
+    template <typename char_t>
+    static std::string to_string(const char_t* s)
+        { return to_string(std::basic_string<char_t>(s)); }
+    template <typename char_t>
+    static std::string to_string(const std::basic_string_view<char_t> s)
+        { return to_string(std::basic_string<char_t>(s)); }
+
+    // misc
+    static std::string to_string(const PyRef& s)
+        { return s.name.str(); }
+    static std::string to_string(Python& s)
+        { return s.name(); }
+    static std::string to_string(std::nullptr_t)
+        { return "NULL"; }
+    static std::string to_string(const std::filesystem::path& s)
+        { return s.string(); }
+    static std::string to_string(const Key& s)
+        { return s.str(); }
+
+    /// Wrapper around PyRef, taking a key, used to access an element
+    template <typename key_t>
+    class PyIndexProxy
+    {
+        /// Force convertion to Python (parent class)
+        Python parent()
+        {
+            return *this;
+        }
+
+    public:
+        PyIndexProxy(const PyRef& object, const Type type, const key_t& key)
+            : object_(object), type_(type), key_(key)
+        {
+            // restrict types (until constraints in C++20)
+            static_assert(std::is_same<key_t, std::string>::value
+                       || std::is_same<key_t, char*>::value
+                       || std::is_convertible<key_t, PyObject*>::value
+                       || std::is_convertible<key_t, int>::value);
+        }
+
+        PyIndexProxy(const PyIndexProxy<key_t>& proxy)
+            : PyIndexProxy(proxy.object_, proxy.type_, proxy.key_)
+        {}
+
+        /// Get the item/attribute \var key of the object (new reference)
+        PyObject* get(PyObject* key)
+        {
+            assert(object_.ptr != nullptr);
+
+            PyObject* ret = nullptr;
+
+            switch (type_)
+            {
+                case Type::Object:  ret = PyObject_GetAttr(object_, key); break;
+                case Type::Dict:
+                    // exact dicts can't override __getitem__, look up directly (using the cached hash)
+                    if (PyDict_CheckExact(object_.ptr))
+                    {
+                        ret = PyDict_GetItemWithError(object_, key);
+
+                        if (ret)
+                            Py_INCREF(ret);
+                        else if (PyErr_Occurred() == nullptr)
+                        {
+                            // wrapped in a tuple so that tuple keys are not unpacked
+                            auto args = PyTuple_Pack(1, key);
+                            PyErr_SetObject(PyExc_KeyError, args);
+                            Py_XDECREF(args);
+                        }
+
+                        break;
+                    }
+                    [[fallthrough]];
+                case Type::Sequence:ret = PyObject_GetItem(object_, key); break;
+            }
+            err("assign");
+
+            return ret;
+        }
+
+        /// Set the item/attribute \var key of the object to \var object
+        void set(PyObject* key, PyObject* object)
+        {
+            assert(object_.ptr != nullptr);
+
+            switch (type_)
+            {
+                case Type::Object:  PyObject_SetAttr(object_, key, object); break;
+                case Type::Dict:
+                case Type::Sequence:PyObject_SetItem(object_, key, object); break;
+            }
+            err("assign");
+        }
+
+        operator PyObject*()
+        {
+            // interned keys are already python objects
+            if constexpr(std::is_same<key_t, Key>::value)
+                return get(key_);
+            else
+                return get(Python(key_));
+        }
+
+        // WARNING: as it's a lazy getter, you need to force convertion if you want to keep the object
+        /// Implicit convertion to Python
+        operator Python()
+        {
+            PyObject* ret = *this;
+
+            if (type_ == Type::Object)
+                return Python(ret, PYNAME(name() + "." + to_string(key_)));
+            else if constexpr(std::is_same<key_t, Python>::value)
+                return Python(ret, PYNAME(name() + "[" + key_.name() + "]"));
+            else if constexpr(std::is_convertible<key_t, std::string>::value
+                           || std::is_same<key_t, Key>::value)
+                return Python(ret, PYNAME(name() + "[\"" + to_string(key_) + "\"]"));
+            else
+                return Python(ret, PYNAME(name() + "[" + to_string(key_) + "]"));
+        }
+
+        auto& operator=(PyObject* object)
+        {
+            if constexpr(std::is_same<key_t, Key>::value)
+                set(key_, object);
+            else
+                set(Python(key_), object);
+
+            return *this;
+        }
+
+        auto& operator=(Python object)
+        {
+            // explicit convertion to avoid looping on itself
+            return operator=(static_cast<PyObject*>(object));
+        }
+
+        // FIXME: ambiguous situations, risk of error
+        // auto proxy = PyIndexProxy()  -> assignation
         // proxy = PyIndexProxy()       -> item setter
         auto& operator=(PyIndexProxy<key_t> proxy)
         {
-            // setter
-            if (object_)
-                operator=(static_cast<PyObject*>(proxy));
-            // assignation
+            // setter
+            if (object_)
+                operator=(static_cast<PyObject*>(proxy));
+            // assignation
+            else
+            {
+                object_ = proxy.object_;
+                type_ = proxy.type_;
+                key_ = proxy.key_;
+            }
+
+            return *this;
+        }
+
+        template <typename T>
+        auto& operator=(T t)
+        {
+            return operator=(Python(t));
+        }
+
+        std::string name() const
+        {
+            return object_.name.str();
+        }
+
+        auto key() const
+        {
+            return key_;
+        }
+
+    // Since we can't overload "operator.()", we need to duck-type our proxy class
+    auto operator[](const std::string& key) { return parent()[key]; }
+    auto operator[](const Py_ssize_t key) { return parent()[key]; }
+    auto operator[](const Key& key) { return parent()[key]; }
+    auto call(Python args = nullptr, Python kwargs = nullptr)
+        { return parent().call(args, kwargs); }
+    auto call_with(Python args, Python kwargs = nullptr)
+        { return parent().call_with(args, kwargs); }
+    auto string(void) { return parent().string(); }
+    auto is_valid(void) { return parent().is_valid(); }
+    auto print(void) { return parent().print(); }
+    template <typename ...Args>
+    auto operator()(Args&&... args) { return parent()(std::forward<Args>(args)...); }
+    template <typename Name, typename ...Args>
+    auto method(const Name& name, Args&&... args)
+        { return parent().method(name, std::forward<Args>(args)...); }
+
+    private:
+        PyRef object_;
+        Type type_;
+        key_t key_;
+    };
+
+    template <typename key_t>
+    static std::string to_string(PyIndexProxy<key_t>& s) { return s.name() + "[" + to_string(s.key()) + "]"; }
+
+    // Use this with caution, it shouldn't be used in place of another constructor
+    // as you can't trace the source
+    // Don't use with any Py_* function returning a new reference (leaks)
+    Python(PyObject* o)
+        : ref_(o, "PyObject*", PyRef::borrow)
+    {}
+
+public:
+    // NOTE: operator[] won't let you access attribute of iterable, you must use attr
+    /// Access operators
+    # define ACCESS(TYPE) auto operator[](TYPE key) \
+    {                                               \
+        assert(is_valid());                         \
+        return PyIndexProxy(ref_, get_type(), key); \
+    }
+    ACCESS(const std::string&)
+    ACCESS(const Py_ssize_t)
+    ACCESS(const Key&)
+    ACCESS(Python)
+
+    /// Release the ressources of the global Python instance
+    /// NOTE: if python was initialized by a GILAcquire, call it without holding the GIL
+    static void terminate(void)
+    {
+        std::lock_guard<std::mutex> lock(initialize_mutex_);
+
+        // the GIL was released after the initialization, take it back with a state of this thread
+        // (the initialization state may belong to another one, it's deleted by Py_Finalize)
+        if (init_state_)
+        {
+            PyGILState_Ensure();
+            init_state_ = nullptr;
+        }
+
+        // cached objects must be released while the interpreter is still alive
+        main_cache_ = InterpreterCache();
+        lookup_epoch_++;
+
+        Py_Finalize();
+        initialized_.store(false, std::memory_order_release);
+    }
+
+    /// Disable/Enable error raising (for the current thread)
+    static void mute_errors(const bool value)
+    {
+        mute_error = value;
+    }
+
+    /// Import the module \var name (cached until removed from sys.modules)
+    static Python import(const std::string& name)
+    {
+        initialize();
+
+        auto entry = cache_->modules.find(name);
+        if (entry != cache_->modules.end())
+        {
+            // the module may have been removed or replaced in sys.modules since
+            auto current = PyDict_GetItemWithError(PyImport_GetModuleDict(), entry->second.key);
+            err("import");
+
+            if (current == entry->second.module.ptr)
+                return Python(entry->second.dict);
+
+            cache_->modules.erase(entry);
+        }
+
+        auto module = Python(PyImport_ImportModule(name.c_str()), name);
+        err("import");
+
+        // errors may be muted
+        if (module.is_valid() == false)
+            return module;
+
+        auto dict = PyModule_GetDict(module);
+        err("import");  // a bit careful doesn't hurt, isn't it ?
+
+        auto key = PyRef(PyUnicode_InternFromString(name.c_str()), name);
+        err("import");
+
+        auto ret = Python(dict, PYNAME("module " + name), PyRef::borrow);
+        cache_->modules.insert_or_assign(name, ModuleEntry{ key, module.ref_, ret.ref_ });
+
+        return ret;
+    }
+
+private:
+    /// Get the object \var attr from the module dict \var dict (ImportError if missing)
+    static Python import_from(Python& dict, [[maybe_unused]] const std::string& module, const std::string& attr)
+    {
+        // borrowed reference, no need to go through a PyIndexProxy
+        auto ptr = PyDict_GetItemString(dict, attr.c_str());
+        if (ptr == nullptr)
+        {
+            PyErr_Format(PyExc_ImportError, "cannot import name '%s' from '%s'", attr.c_str(), module.c_str());
+            err("from_import");
+        }
+
+        return Python(ptr, PYNAME(module + "." + attr), PyRef::borrow);
+    }
+
+public:
+    /// Import objects from the module \var name (the module is only looked up once)
+    template <typename ...Args>
+    static auto from_import(const std::string& name, const Args&... args)
+    {
+        auto dict = import(name);
+
+        return std::tuple<decltype(args, Python())...>{ import_from(dict, name, args)... };
+    }
+
+    /// Return the python builtins
+    static Python builtins(void)
+    {
+        initialize();
+
+        auto ptr = PyEval_GetBuiltins();
+        err("builtins");
+
+        return Python(ptr, "builtins", PyRef::borrow);
+    }
+
+    /// Call a builtin function
+    static Python call_builtin(const std::string& name, Python args = nullptr, Python kwargs = nullptr)
+    {
+        auto main = builtins();
+        return main[name].call(args, kwargs);
+    }
+
+    /// Compile python code, \var mode being Py_eval_input, Py_file_input or Py_single_input
+    /// The code objects are kept in a LRU cache (by source and mode, see set_code_cache_size)
+    static Python compile(const std::string& source, const int mode = Py_eval_input)
+    {
+        initialize();
+
+        auto& codes = cache_->codes;
+
+        std::string key = source;
+        key.push_back('\0');
+        key += std::to_string(mode);
+
+        auto entry = codes.index.find(key);
+        if (entry != codes.index.end())
+        {
+            // most recently used first
+            codes.order.splice(codes.order.begin(), codes.order, entry->second);
+            return Python(entry->second->second.ptr, entry->second->second.name, PyRef::borrow);
+        }
+
+        auto ptr = Py_CompileString(source.c_str(), "<string>", mode);
+        err("compile");
+
+        auto code = Python(ptr, PYNAME("compile(" + source + ")"));
+        if (code.is_valid() == false || code_cache_size_ == 0)
+            return code;
+
+        trim_codes(code_cache_size_ - 1);
+
+        codes.order.emplace_front(key, code.ref_);
+        codes.index.emplace(std::move(key), codes.order.begin());
+
+        return code;
+    }
+
+    /// Set the number of code objects kept by compile (128 by default)
+    static void set_code_cache_size(const std::size_t size)
+    {
+        initialize();
+
+        code_cache_size_ = size;
+        trim_codes(size);
+    }
+
+    /// Run the code object \var code (see compile) with \var globals (a dict) and \var locals
+    static Python eval(Python code, Python globals, Python locals)
+    {
+        assert(code.is_valid() && globals.is_valid() && locals.is_valid());
+
+        auto ret = PyEval_EvalCode(code, globals, locals);
+        err("eval");
+
+        return Python(ret, PYNAME("eval(" + code.name() + ")"));
+    }
+
+    /// Evaluate python code
+    static Python eval(const std::string& content, int type, Python globals, Python locals)
+    {
+        assert(globals.is_valid() && PyDict_Check(globals.ref_.ptr));
+
+        // builtins are only added once to the globals
+        const auto key = builtins_key();
+        if (PyDict_Contains(globals, key) == 0)
+            PyDict_SetItem(globals, key, PyEval_GetBuiltins());
+        err("eval");
+
+        return eval(compile(content, type), globals, locals);
+    }
+
+private:
+    /// Drop the least recently used code objects, keeping at most \var size of them
+    static void trim_codes(const std::size_t size)
+    {
+        auto& codes = cache_->codes;
+
+        while (codes.order.size() > size)
+        {
+            codes.index.erase(codes.order.back().first);
+            codes.order.pop_back();
+        }
+    }
+
+    /// Interned "__builtins__" (_key is only defined after the class)
+    static Key builtins_key(void)
+    {
+        static const char literal[] = "__builtins__";
+        return Key(literal, sizeof(literal) - 1);
+    }
+
+public:
+    /// Globals prepared once to run python code again and again (with different locals)
+    class Context
+    {
+    public:
+        Context(void)
+            : globals_((initialize(), PyDict_New()), "globals")
+        {
+            err("context");
+
+            PyDict_SetItem(globals_, builtins_key(), PyEval_GetBuiltins());
+            err("context");
+        }
+
+        /// Evaluate the expression \var expr (compiled once, see compile)
+        Python eval(const std::string& expr)
+        {
+            return Python::eval(compile(expr, Py_eval_input), globals(), globals());
+        }
+
+        /// Evaluate the expression \var expr with the variables of \var locals (a mapping)
+        Python eval(const std::string& expr, Python locals)
+        {
+            return Python::eval(compile(expr, Py_eval_input), globals(), locals);
+        }
+
+        /// Run the statements \var code in the globals (definitions, imports...)
+        void exec(const std::string& code)
+        {
+            Python::eval(compile(code, Py_file_input), globals(), globals());
+        }
+
+        /// Global variables of the context
+        Python globals(void) const
+        {
+            return Python(globals_.ptr, globals_.name, PyRef::borrow);
+        }
+
+    private:
+        PyRef globals_;
+    };
+
+private:
+    /// Append \var part to the comma-separated debug name \var name (no-op if names are disabled)
+    static void join_name([[maybe_unused]] std::string& name, [[maybe_unused]] const std::string& part)
+    {
+        if constexpr(PyName::enabled)
+        {
+            if (name.empty() == false)
+                name += ", ";
+
+            name += part;
+        }
+    }
+
+    /// Debug name of a starred expression (empty if names are disabled)
+    static std::string star_name([[maybe_unused]] const Python& obj)
+    {
+        if constexpr(PyName::enabled)
+            return "*" + obj.name();
+        else
+            return std::string();
+    }
+
+    /// Debug name of a key/item pair (empty if names are disabled)
+    static std::string pair_name([[maybe_unused]] const Python& key, [[maybe_unused]] const Python& item)
+    {
+        if constexpr(PyName::enabled)
+            return key.name() + ": " + item.name();
+        else
+            return std::string();
+    }
+
+    /// New str from the characters of \var t (UTF-8, UTF-16 or UTF-32 following their size)
+    template <typename charT>
+    static PyObject* new_unicode(const std::basic_string_view<charT> t)
+    {
+        if constexpr(std::is_same<charT, char>::value)
+            return PyUnicode_FromStringAndSize(t.data(), t.size());
+        else if constexpr(std::is_same<charT, wchar_t>::value)
+            return PyUnicode_FromWideChar(t.data(), t.size());
+        else if constexpr(sizeof(charT) == 2)
+        {
+            // native byte order
+            int order = PY_LITTLE_ENDIAN ? -1 : 1;
+            return PyUnicode_DecodeUTF16(reinterpret_cast<const char*>(t.data()), t.size() * 2, nullptr, &order);
+        }
+        else
+        {
+            static_assert(sizeof(charT) == 4, "unsupported character type");
+            return PyUnicode_FromKindAndData(PyUnicode_4BYTE_KIND, t.data(), t.size());
+        }
+    }
+
+    /// Create a new reference from \var t, directly for numbers and strings
+    template <typename T>
+    static PyObject* new_reference(const T& t)
+    {
+        using B = typename std::remove_cv<T>::type;
+        constexpr bool is_char = std::is_same<B, char>::value || std::is_same<B, wchar_t>::value
+                              || std::is_same<B, char16_t>::value || std::is_same<B, char32_t>::value;
+
+        if constexpr(std::is_same<B, bool>::value)
+        {
+            auto ptr = t ? Py_True : Py_False;
+            Py_INCREF(ptr);
+
+            return ptr;
+        }
+        else if constexpr(std::is_floating_point<B>::value)
+            return PyFloat_FromDouble(t);
+        else if constexpr(std::is_integral<B>::value && is_char == false && std::is_signed<B>::value)
+            return PyLong_FromLongLong(t);
+        else if constexpr(std::is_integral<B>::value && is_char == false)
+            return PyLong_FromUnsignedLongLong(t);
+        else if constexpr(std::is_same<B, std::string>::value || std::is_same<B, std::string_view>::value)
+            return PyUnicode_FromStringAndSize(t.data(), t.size());
+        // nested containers and user types
+        else
+            return Python(t).release();
+    }
+
+    /// New list (or tuple) holding the items of \var iter
+    /// Iterables without size are appended to the list, or fill a tuple resized as it grows
+    template <bool is_list, typename Iterable>
+    static Python new_sequence(const Iterable& iter)
+    {
+        static_assert(is_iterable<Iterable>::value);
+
+        constexpr bool sized = has_size<Iterable>::value;
+        const char* func = is_list ? "list" : "tuple";
+
+        initialize();
+
+        // the capacity of a tuple of unknown size is doubled when it is full
+        Py_ssize_t size = is_list ? 0 : 8;
+        if constexpr(sized)
+            size = std::size(iter);
+
+        auto obj = Python(is_list ? PyList_New(size) : PyTuple_New(size), func);
+        err(func);
+
+        // errors may be muted
+        if (obj.is_valid() == false)
+            return obj;
+
+        std::string name;
+        Py_ssize_t i = 0;
+
+        for (const auto& e : iter)
+        {
+            // the same conversion with or without names, only the name is computed on the side
+            PyObject* item = new_reference(e);
+
+            if constexpr(PyName::enabled)
+            {
+                using E = typename std::remove_cv<typename std::remove_reference<decltype(e)>::type>::type;
+
+                if constexpr(std::is_same<E, std::string>::value || std::is_same<E, std::string_view>::value)
+                    join_name(name, "\"" + to_string(e) + "\"");
+                else if constexpr(std::is_arithmetic<E>::value)
+                    join_name(name, to_string(e));
+                else if (item)
+                    join_name(name, Python(item, "item", PyRef::borrow).name());
+            }
+
+            // the unfilled slots are NULL, which is safe for the deallocation of obj
+            // (never given back, even when the error is muted)
+            if (item == nullptr)
+            {
+                err(func);
+                return Python();
+            }
+
+            if constexpr(is_list && sized == false)
+            {
+                const int ret = PyList_Append(obj.ref_.ptr, item);
+                Py_DECREF(item);
+
+                if (ret < 0)
+                {
+                    err(func);
+                    return Python();
+                }
+            }
+            else if constexpr(is_list)
+                PyList_SET_ITEM(obj.ref_.ptr, i, item);
+            else
+            {
+                // the tuple isn't shared yet, it can still be resized
+                if (sized == false && i == size && _PyTuple_Resize(&obj.ref_.ptr, size *= 2) < 0)
+                {
+                    Py_DECREF(item);
+                    err(func);
+                    return Python();
+                }
+
+                PyTuple_SET_ITEM(obj.ref_.ptr, i, item);
+            }
+
+            i++;
+        }
+
+        if constexpr(is_list == false && sized == false)
+        {
+            if (i != size && _PyTuple_Resize(&obj.ref_.ptr, i) < 0)
+            {
+                err(func);
+                return Python();
+            }
+        }
+
+        obj.ref_.name = PYNAME((is_list ? "[" : "(") + name + (is_list ? "]" : ")"));
+
+        return obj;
+    }
+
+    /// Assign object \var obj at the ith slot of tuple
+    template <typename T>
+    static std::string tuple_assign(PyObject** ptr, std::size_t& i, T t)
+    {
+        Python obj = Python(t);
+
+        if constexpr(is_starred<0, T>::value)
+        {
+            /// Target size (size of the container to fill)
+            const std::size_t t_size = PyObject_Size(*ptr);
+            /// Container size (size of the container to get items from)
+            const std::size_t c_size = PyObject_Size(obj);
+
+            _PyTuple_Resize(ptr, t_size + c_size - 1);
+            err("tuple");
+
+            for (std::size_t index = 0; index < c_size; index++, i++)
+                PyTuple_SetItem(*ptr, i, PySequence_GetItem(obj, index));
+            err("tuple");
+
+            return star_name(obj);
+        }
+        else
+        {
+            PyTuple_SetItem(*ptr, i++, obj.release());
+            err("tuple");
+
+            return obj.name();
+        }
+    }
+
+    /// Collect the arguments of a C++ tuple to put them in a python tuple
+    template <std::size_t pos, typename ...Args>
+    static std::string tuple_caller(PyObject** ptr, std::size_t& i, const std::tuple<Args...>& args)
+    {
+        auto name = tuple_assign(ptr, i, std::get<pos>(args));
+
+        if constexpr(pos + 1 < sizeof...(Args))
+            join_name(name, tuple_caller<pos + 1>(ptr, i, args));
+
+        return name;
+    }
+
+public:
+    /// Create a tuple from C++ tuple
+    template <typename ...Args>
+    static Python tuple(const std::tuple<Args...>& args)
+    {
+        initialize();
+
+        constexpr auto size = sizeof...(Args);
+        auto ptr = PyTuple_New(size);
+        err("tuple");
+
+        if constexpr(sizeof...(Args))
+        {
+            std::size_t i = 0;
+            const auto name = tuple_caller<0>(&ptr, i, args);
+            return Python(ptr, PYNAME("(" + name + ")"));
+        }
+        else
+            return Python(ptr, "()");
+    }
+
+    /// Create a tuple from all the passed arguments
+    template <typename ...Args>
+    static Python tuple(Args... args)
+    {
+        return tuple(std::tuple(args...));
+    }
+
+    /// Create a tuple from C++ iterable
+    template <typename Iterable>
+    static Python tuple(const Iterable& iter)
+    {
+        return new_sequence<false>(iter);
+    }
+
+    /// Create a tuple from python iterable
+    static Python tuple(Python o)
+    {
+        assert(o.is_valid());
+
+        auto ptr = PySequence_Tuple(o);
+        err("tuple");
+
+        return Python(ptr, PYNAME("tuple(" + o.name() + ")"));
+    }
+
+private:
+    /// Assign object \var obj at the ith slot of list
+    template <typename T>
+    static std::string list_assign(PyObject* ptr, T t)
+    {
+        Python obj = Python(t);
+
+        if constexpr(is_starred<0, T>::value)
+        {
+            /// Container size (size of the container to get items from)
+            const std::size_t c_size = PyObject_Size(obj);
+            for (std::size_t index = 0; index < c_size; index++)
+                PyList_Append(ptr, Python(PySequence_GetItem(obj, index), "item"));
+            err("list");
+
+            return star_name(obj);
+        }
+        else
+        {
+            // PyList_Append doesn't steal the reference
+            PyList_Append(ptr, obj);
+            err("list");
+
+            return obj.name();
+        }
+    }
+
+    /// Collect the arguments of a C++ tuple to put them in a python list
+    template <std::size_t pos, typename ...Args>
+    static std::string list_caller(PyObject* ptr, const std::tuple<Args...>& args)
+    {
+        auto name = list_assign(ptr, std::get<pos>(args));
+
+        if constexpr(pos + 1 < sizeof...(Args))
+            join_name(name, list_caller<pos + 1>(ptr, args));
+
+        return name;
+    }
+
+public:
+    /// Create a list from C++ tuple
+    template <typename ...Args>
+    static Python list(const std::tuple<Args...>& args)
+    {
+        initialize();
+
+        auto ptr = PyList_New(0);
+        err("list");
+
+        if constexpr(sizeof...(Args))
+        {
+            const auto name = list_caller<0>(ptr, args);
+            return Python(ptr, PYNAME("[" + name + "]"));
+        }
+        else
+            return Python(ptr, "[]");
+    }
+
+    /// Create a list from all the passed arguments
+    template <typename ...Args>
+    static Python list(Args... args)
+    {
+        return list(std::tuple(args...));
+    }
+
+    /// Create a list from C++ iterable
+    template <typename Iterable>
+    static Python list(const Iterable& iter)
+    {
+        return new_sequence<true>(iter);
+    }
+
+    /// Create a list from python iterable
+    static Python list(Python o)
+    {
+        assert(o.is_valid());
+
+        auto ptr = PySequence_List(o);
+        err("list");
+
+        return Python(ptr, PYNAME("list(" + o.name() + ")"));
+    }
+
+private:
+    /// New dict with room for \var size items (no resize while filling it)
+    static Python new_dict(const std::size_t size)
+    {
+        initialize();
+
+        # ifdef Py_LIMITED_API
+            auto ptr = PyDict_New();
+            (void) size;
+        # else
+            auto ptr = _PyDict_NewPresized(size);
+        # endif
+        err("dict");
+
+        return Python(ptr, "dict");
+    }
+
+    /// Set \var dict[\var k] = \var i, directly for numbers and strings
+    /// Return the debug name of the pair (empty if names are disabled)
+    template <typename K, typename T>
+    static std::string dict_set(PyObject* dict, const K& k, const T& i)
+    {
+        // full conversion to keep track of the names
+        if constexpr(PyName::enabled)
+        {
+            auto key = Python(k);
+            auto item = Python(i);
+
+            PyDict_SetItem(dict, key, item);
+            err("dict");
+
+            return pair_name(key, item);
+        }
+        else
+        {
+            auto key = PyRef(new_reference(k), "key");
+            auto item = PyRef(new_reference(i), "item");
+
+            if (key && item)
+                PyDict_SetItem(dict, key, item);
+            err("dict");
+
+            return std::string();
+        }
+    }
+
+    /// Collect the args (key, value pairs) and put them into the dict
+    template <typename K, typename T, typename ...Args>
+    static std::string dict_assign(Python& dict, const K& k, const T& i, const Args&... items)
+    {
+        assert(dict.is_valid());
+
+        auto name = dict_set(dict, k, i);
+
+        if constexpr(sizeof...(Args))
+            join_name(name, dict_assign(dict, items...));
+
+        return name;
+    }
+
+    /// Overload of dict_assign for pair
+    template <typename K, typename T>
+    static std::string dict_assign(Python& dict, const std::pair<K, T>& p)
+    {
+        assert(dict.is_valid());
+
+        return dict_set(dict, p.first, p.second);
+    }
+
+public:
+    /// Create a dictionnary from all the passed objects
+    template <typename ...Args>
+    static Python dict(Args... items)
+    {
+        // pairs or key, value arguments, at most one item per argument
+        auto obj = new_dict(sizeof...(Args));
+        if constexpr(sizeof...(Args))
+        {
+            const auto name = dict_assign(obj, items...);
+            obj.ref_.name = PYNAME("{" + name + "}");
+        }
+
+        return obj;
+    }
+
+    /// Overload of dict for iterable of pairs (std::map, std::unordered_map, ranges of pairs...)
+    template <typename Iterable>
+    static Python dict(const Iterable& i)
+    {
+        static_assert(is_iterable<Iterable>::value);
+
+        std::size_t size = 0;
+        if constexpr(has_size<Iterable>::value)
+            size = std::size(i);
+
+        auto obj = new_dict(size);
+
+        std::string name;
+        for (const auto& e : i)
+            join_name(name, dict_set(obj, e.first, e.second));
+
+        obj.ref_.name = PYNAME("{" + name + "}");
+
+        return obj;
+    }
+
+    /// Create a dictionnary from passed \var keys iterable and \var values iterable
+    static Python dict(Python keys, Python values)
+    {
+        assert(keys.size() == values.size());
+
+        auto obj = new_dict(keys.size());
+        obj.ref_.name = PYNAME("dict(keys = " + keys.name() + ", values = " + values.name() + ")");
+
+        auto value = values.begin();
+        for (auto key : keys)
+        {
+            PyDict_SetItem(obj, key, *value);
+            err("dict");
+
+            ++value;
+        }
+
+        return obj;
+    }
+
+    /// Add the pairs of the C++ map (or range of pairs) \var m to the dict, replacing existing keys
+    template <typename Map>
+    Python& update(const Map& m)
+    {
+        static_assert(is_iterable<Map>::value);
+        assert(is_valid() && PyDict_Check(ref_.ptr));
+
+        for (const auto& e : m)
+            dict_set(ref_, e.first, e.second);
+
+        return *this;
+    }
+
+    /// Add the items of the mapping \var o to the dict (existing keys only replaced if \var override)
+    Python& merge(Python o, const bool override = true)
+    {
+        assert(is_valid() && PyDict_Check(ref_.ptr) && o.is_valid());
+
+        PyDict_Merge(ref_, o, override);
+        err("merge");
+
+        return *this;
+    }
+
+    /// Add the items of the mapping \var o to the dict, replacing existing keys
+    Python& update(Python o)
+    {
+        return merge(o, true);
+    }
+
+    /// Create a set from the iterable \var o
+    static Python set(Python o)
+    {
+        assert(PyTuple_Check(o) || PyList_Check(o));
+
+        auto ptr = PySet_New(o);
+        err("set");
+
+        return Python(ptr, PYNAME("set(" + o.name() + ")"));
+    }
+
+    /*===== CONSTRUCTORS =====*/
+    template <typename A, typename B>
+    Python(const std::pair<A, B>& p)
+    {
+        *this = tuple(p.first, p.second);
+        assert(is_valid());
+    }
+
+    /// List of the keys, values or items of a dict
+    template <DictPart part>
+    Python(const DictView<part>& view)
+        : Python(view.list())
+    {}
+
+    template <typename T>
+    Python(const std::vector<T>& v)
+    {
+        *this = list(v);
+        assert(is_valid());
+    }
+
+    // avoid ambiguouty with vector-like (like string) structures and vector
+    template <typename T>
+    Python(const std::initializer_list<T>& v)
+    {
+        *this = list(v);
+        assert(is_valid());
+    }
+
+    template <typename T, std::size_t N>
+    Python(const std::array<T, N>& v)
+    {
+        *this = list(v);
+        assert(is_valid());
+    }
+
+    template <typename T>
+    Python(const std::list<T>& v)
+    {
+        *this = list(v);
+        assert(is_valid());
+    }
+
+    template <typename K, typename T>
+    Python(const std::map<K, T>& v)
+    {
+        *this = dict(v);
+        assert(is_valid());
+    }
+
+    template <typename ...Args>
+    Python(const std::tuple<Args...>& v)
+    {
+        *this = tuple(v);
+        assert(is_valid());
+    }
+
+    template <typename T>
+    Python(const std::optional<T>& t)
+    {
+        if (t.has_value())
+            *this = Python(t.value());
+        else
+            *this = None;
+    }
+
+    // Generic constructor working with any type of string (as long as python support them)
+    /// std::string is decoded as UTF-8, std::u16string as UTF-16 and std::u32string as UTF-32
+    template <typename charT>
+    Python(const std::basic_string<charT>& t)
+        : Python(std::basic_string_view<charT>(t))
+    {}
+
+    /// Same as the strings, without copy of the content
+    template <typename charT>
+    Python(const std::basic_string_view<charT> t)
+    {
+        initialize();
+        ref_ = PyRef(new_unicode(t), PYNAME("\"" + to_string(t) + "\""));
+        err("Python");
+    }
+
+    /// String known to be 7-bit ASCII, copied without decoding
+    Python(const std::string_view t, Ascii)
+    {
+        initialize();
+
+        auto ptr = PyUnicode_New(t.size(), 127);
+        if (ptr)
+        {
+            assert(std::all_of(t.begin(), t.end(), [](const char c) { return (c & 0x80) == 0; }));
+            std::memcpy(PyUnicode_DATA(ptr), t.data(), t.size());
+        }
+
+        ref_ = PyRef(ptr, PYNAME("\"" + std::string(t) + "\""));
+        err("Python");
+    }
+
+    /// Interned string, shared by all the equal interned strings (for repeated identifiers)
+    Python(const std::string_view t, Interned)
+        : Python(t)
+    {
+        if (ref_)
+            PyUnicode_InternInPlace(&ref_.ptr);
+    }
+
+    template <typename charT>
+    explicit Python(const charT* t)
+        : Python(std::basic_string_view<charT>(t))
+    {
+        static_assert(std::is_same<charT, char>::value
+                   || std::is_same<charT, wchar_t>::value
+                   || std::is_same<charT, char16_t>::value
+                   || std::is_same<charT, char32_t>::value);
+    }
+
+    template <typename T>
+    Python(PyIndexProxy<T> t)
+    {
+        *this = t;
+    }
+
+    template <typename T>
+    Python(Starred<T> t)
+    {
+        *this = t;
+    }
+
+    Python(const PyRef& ref)
+        : ref_(ref)
+    {}
+
+    Python(PyRef&& ref) noexcept
+        : ref_(std::move(ref))
+    {}
+
+    /// Default constructor
+    Python(void)
+    {}
+
+    /// Default constructor for nullptr (seamlessly pass nullptr)
+    Python(std::nullptr_t)
+    {}
+
+    /// Copy constructor
+    Python(const Python& o)
+        : ref_(o.ref_)
+    {}
+
+    /// Move constructor (no INCREF/DECREF)
+    Python(Python&& o) noexcept
+        : ref_(std::move(o.ref_))
+    {}
+
+    /// Path decoded like os.fsdecode (native wide characters on Windows)
+    explicit Python(const std::filesystem::path& t)
+    {
+        initialize();
+
+        # ifdef _WIN32
+            auto ptr = PyUnicode_FromWideChar(t.c_str(), t.native().size());
+        # else
+            auto ptr = PyUnicode_DecodeFSDefaultAndSize(t.c_str(), t.native().size());
+        # endif
+
+        ref_ = PyRef(ptr, PYNAME("\"" + to_string(t) + "\""));
+        err("Python");
+    }
+
+    // unified interface to get rid of ambiguous overloads
+    // (typed handles like PyList are sliced by the copy constructor instead)
+    template <typename T, typename B = typename std::remove_cv<T>::type,
+              typename = typename std::enable_if<std::is_base_of<Python, B>::value == false>::type>
+    explicit Python(const T t)
+    {
+        // forbid this contructor to supplant the other ones
+        static_assert(std::is_same<B, PyRef>::value == false
+                   && std::is_same<B, Python>::value == false
+                   && std::is_same<B, std::string>::value == false
+                   && std::is_same<B, std::string_view>::value == false
+                   && std::is_same<B, std::nullptr_t>::value == false
+                   && std::is_same<B, PyIndexProxy<std::string>>::value == false
+                   && std::is_same<B, PyIndexProxy<Python>>::value == false
+                   && std::is_same<B, PyIndexProxy<Py_ssize_t>>::value == false
+                   && std::is_same<B, PyIndexProxy<Key>>::value == false);
+
+        initialize();
+        // char
+        if constexpr(std::is_same<B, char>::value || std::is_same<B, wchar_t>::value || std::is_same<B, char16_t>::value || std::is_same<B, char32_t>::value)
+            ref_ = PyRef(PyUnicode_FromKindAndData(sizeof(B), &t, 1), PYNAME(to_string(t)));
+        // floatant
+        else if constexpr(std::is_same<B, float>::value)
+            ref_ = PyRef(PyFloat_FromDouble(t), PYNAME(to_string(t) + "f"));
+        else if constexpr(std::is_same<B, double>::value)
+            ref_ = PyRef(PyFloat_FromDouble(t), PYNAME(to_string(t)));
+        else if constexpr(std::is_same<B, long double>::value)
+            ref_ = PyRef(PyFloat_FromDouble(t), PYNAME(to_string(t) + "l"));
+        // signed
+        else if constexpr(std::is_same<B, Py_ssize_t>::value)
+            ref_ = PyRef(PyLong_FromSsize_t(t), PYNAME(to_string(t) + "ssz"));
+        else if constexpr(std::is_same<B, int8_t>::value)
+            ref_ = PyRef(PyLong_FromLong(t), PYNAME(to_string(t) + "ss"));
+        else if constexpr(std::is_same<B, short>::value || std::is_same<B, int16_t>::value)
+            ref_ = PyRef(PyLong_FromLong(t), PYNAME(to_string(t) + "s"));
+        else if constexpr(std::is_same<B, int>::value)
+            ref_ = PyRef(PyLong_FromLong(t), PYNAME(to_string(t)));
+        else if constexpr(std::is_same<B, long>::value)
+            ref_ = PyRef(PyLong_FromLong(t), PYNAME(to_string(t) + "l"));
+        else if constexpr(std::is_same<B, long long>::value)
+            ref_ = PyRef(PyLong_FromLongLong(t), PYNAME(to_string(t) + "ll"));
+        // unsigned
+        else if constexpr(std::is_same<B, std::size_t>::value)
+            ref_ = PyRef(PyLong_FromSize_t(t), PYNAME(to_string(t) + "sz"));
+        else if constexpr(std::is_same<B, uint8_t>::value)
+            ref_ = PyRef(PyLong_FromLong(t), PYNAME(to_string(t) + "uss"));
+        else if constexpr(std::is_same<B, unsigned short>::value)
+            ref_ = PyRef(PyLong_FromLong(t), PYNAME(to_string(t) + "us"));
+        else if constexpr(std::is_same<B, unsigned int>::value)
+            ref_ = PyRef(PyLong_FromUnsignedLong(t), PYNAME(to_string(t) + "u"));
+        else if constexpr(std::is_same<B, unsigned long>::value)
+            ref_ = PyRef(PyLong_FromUnsignedLong(t), PYNAME(to_string(t) + "ul"));
+        else if constexpr(std::is_same<B, unsigned long long>::value)
+            ref_ = PyRef(PyLong_FromUnsignedLongLong(t), PYNAME(to_string(t) + "ull"));
+
+        // bool was too tedious to let alone because of multiple convertions to it
+        else if constexpr(std::is_same<B, bool>::value)
+            ref_ = t ? True : False;
+        // in case you didn't activate unused variables
+        else throw std::logic_error("Tried to convert unimplemented type to Python type:" + GET_TYPENAME(0));
+
+        err("Python");
+
+        // verify validity after (they must all be valid)
+        assert(is_valid());
+    }
+
+    /// Take ownership of the new reference \var ptr
+    Python(PyObject* ptr, PyName name, PyRef::Steal = PyRef::steal)
+        : ref_(ptr, std::move(name), PyRef::steal)
+    {}
+
+    /// Share the borrowed reference \var ptr
+    Python(PyObject* ptr, PyName name, PyRef::Borrow)
+        : ref_(ptr, std::move(name), PyRef::borrow)
+    {}
+
+    /// Take ownership of the new reference \var ptr (returned by most Py* functions)
+    static Python steal(PyObject* ptr)
+    {
+        return Python(ptr, "PyObject*", PyRef::steal);
+    }
+
+    /// Share the borrowed reference \var ptr (like the items of PyTuple_GetItem)
+    static Python borrow(PyObject* ptr)
+    {
+        return Python(ptr, "PyObject*", PyRef::borrow);
+    }
+
+    /// Give up the ownership of the object (to pass it to a function stealing it)
+    PyObject* release(void)
+    {
+        return ref_.release();
+    }
+
+    /*===== OPERATORS =====*/
+    /// Copy operator
+    Python& operator=(const Python& o)
+    {
+        ref_ = o.ref_;
+        return *this;
+    }
+
+    /// Move operator (no INCREF/DECREF)
+    Python& operator=(Python&& o) noexcept
+    {
+        ref_ = std::move(o.ref_);
+        return *this;
+    }
+
+    /// Implicit convertion to PyObject*
+    operator PyObject*()
+    {
+        return ref_;
+    }
+
+    # define COMPARISON(OP, CMP)                                                \
+        Python OP(Python o)                                                     \
+        {                                                                       \
+            assert(is_valid() && o.is_valid());                                 \
+            auto ptr = PyObject_RichCompare(ref_, o, Py_##CMP);                 \
+            err(#OP);                                                           \
+            auto ret = Python(ptr, PYNAME(name() + " " + (#OP + 8) + " " + o.name())); \
+                                                                                \
+            return ret;                                                         \
+        }
+
+    // Comparison operators
+    COMPARISON(operator<,   LT)
+    COMPARISON(operator<=,  LE)
+    COMPARISON(operator==,  EQ)
+    COMPARISON(operator!=,  NE)
+    COMPARISON(operator>,   GT)
+    COMPARISON(operator>=,  GE)
+
+    # define OPERATION(OP, SYM, FUNC)                                            \
+        Python OP(Python o)                                                     \
+        {                                                                       \
+            assert(is_valid() && o.is_valid());                                 \
+            auto ptr = FUNC(ref_, o);                                           \
+            err(#OP);                                                           \
+                                                                                \
+            return Python(ptr, PYNAME(name() + " " SYM " " + o.name()));        \
+        }
+
+    // Arithmetic operators (sequence concatenation and repetition included)
+    OPERATION(operator+,    "+",    PyNumber_Add)
+    OPERATION(operator-,    "-",    PyNumber_Subtract)
+    OPERATION(operator*,    "*",    PyNumber_Multiply)
+    OPERATION(operator/,    "/",    PyNumber_TrueDivide)
+    OPERATION(operator%,    "%",    PyNumber_Remainder)
+    OPERATION(operator>>,   ">>",   PyNumber_Rshift)
+    OPERATION(operator<<,   "<<",   PyNumber_Lshift)
+    OPERATION(operator&,    "&",    PyNumber_And)
+    OPERATION(operator^,    "^",    PyNumber_Xor)
+    OPERATION(operator|,    "|",    PyNumber_Or)
+
+    // Arithmetic operators without C++ equivalent
+    OPERATION(floordiv,     "//",   PyNumber_FloorDivide)
+    OPERATION(matmul,       "@",    PyNumber_MatrixMultiply)
+
+    # define INPLACE_OPERATION(OP, SYM, FUNC)                                    \
+        Python& OP(Python o)                                                    \
+        {                                                                       \
+            assert(is_valid() && o.is_valid());                                 \
+            auto ptr = FUNC(ref_, o);                                           \
+            err(#OP);                                                           \
+                                                                                \
+            return (*this = Python(ptr, PYNAME(name() + " " SYM " " + o.name())));\
+        }
+
+    // Inplace arithmetic operators
+    // Immutable objects (like int) don't have inplace slots, Python then falls back on
+    // the normal operator and returns a new object, hence the reassignment
+    INPLACE_OPERATION(operator+=,   "+=",   PyNumber_InPlaceAdd)
+    INPLACE_OPERATION(operator-=,   "-=",   PyNumber_InPlaceSubtract)
+    INPLACE_OPERATION(operator*=,   "*=",   PyNumber_InPlaceMultiply)
+    INPLACE_OPERATION(operator/=,   "/=",   PyNumber_InPlaceTrueDivide)
+    INPLACE_OPERATION(operator%=,   "%=",   PyNumber_InPlaceRemainder)
+    INPLACE_OPERATION(operator>>=,  ">>=",  PyNumber_InPlaceRshift)
+    INPLACE_OPERATION(operator<<=,  "<<=",  PyNumber_InPlaceLshift)
+    INPLACE_OPERATION(operator&=,   "&=",   PyNumber_InPlaceAnd)
+    INPLACE_OPERATION(operator^=,   "^=",   PyNumber_InPlaceXor)
+    INPLACE_OPERATION(operator|=,   "|=",   PyNumber_InPlaceOr)
+    INPLACE_OPERATION(ifloordiv,    "//=",  PyNumber_InPlaceFloorDivide)
+    INPLACE_OPERATION(imatmul,      "@=",   PyNumber_InPlaceMatrixMultiply)
+
+    /// Return self ** \var o (% \var mod if given)
+    Python pow(Python o, Python mod = None)
+    {
+        assert(is_valid() && o.is_valid() && mod.is_valid());
+
+        auto ptr = PyNumber_Power(ref_, o, mod);
+        err("pow");
+
+        return Python(ptr, PYNAME("pow(" + name() + ", " + o.name()
+                                + (static_cast<PyObject*>(mod) == Py_None ? "" : ", " + mod.name()) + ")"));
+    }
+
+    /// Inplace version of pow
+    Python& ipow(Python o, Python mod = None)
+    {
+        assert(is_valid() && o.is_valid() && mod.is_valid());
+
+        auto ptr = PyNumber_InPlacePower(ref_, o, mod);
+        err("ipow");
+
+        return (*this = Python(ptr, PYNAME(name() + " **= " + o.name())));
+    }
+
+    /// Return the absolute value of the object
+    Python abs(void)
+    {
+        assert(is_valid());
+
+        auto ptr = PyNumber_Absolute(ref_);
+        err("abs");
+
+        return Python(ptr, PYNAME("abs(" + name() + ")"));
+    }
+
+    /*===== MISC =====*/
+    Python contains(Python o)
+    {
+        assert(is_valid() && o.is_valid());
+
+        const auto ret = PySequence_Contains(ref_, o);
+        err("contains");
+
+        return Python(PyBool_FromLong(ret), PYNAME(o.name() + " in " + name()));
+    }
+
+    Python in(Python o)
+    {
+        return o.contains(*this);
+    }
+
+    Python count_of(Python o)
+    {
+        assert(is_valid() && o.is_valid());
+
+        const auto ret = PySequence_Count(ref_, o);
+        err("count_of");
+
+        return Python(PyLong_FromSsize_t(ret), PYNAME(o.name() + ".countOf(" + name() + ")"));
+    }
+
+    Python index_of(Python o)
+    {
+        assert(is_valid() && o.is_valid());
+
+        const auto ret = PySequence_Index(ref_, o);
+        err("index_of");
+
+        return Python(PyLong_FromSsize_t(ret), PYNAME(o.name() + ".indexOf(" + name() + ")"));
+    }
+
+private:
+    template <std::size_t i, typename ...Args>
+    class is_starred
+    {
+    public:
+        using type = typename std::tuple_element<i, std::tuple<Args...>>::type;
+        static constexpr bool value = std::is_same<type, Starred<Python>>::value
+                                   || std::is_same<type, Starred<PyIndexProxy<std::string>>>::value
+                                   || std::is_same<type, Starred<PyIndexProxy<Py_ssize_t>>>::value
+                                   || std::is_same<type, Starred<PyIndexProxy<Key>>>::value
+                                   || std::is_same<type, Starred<PyIndexProxy<Python>>>::value;
+    };
+
+    template <typename T, typename ...Args>
+    class starred_count
+    {
+    public:
+        static constexpr std::size_t value = is_starred<0, T>::value
+                                           + starred_count<Args...>::value;
+    };
+
+
+    template <typename T>
+    class starred_count<T>
+    {
+    public:
+        static constexpr std::size_t value = is_starred<0, T>::value;
+    };
+
+    static void assign_error_not_enough(const std::size_t expected, const std::size_t got)
+    {
+        std::stringstream msg;
+        msg << "not enough values to unpack (expected "
+            << expected << ", got " << got << ")";
+        PyErr_SetString(PyExc_ValueError, msg.str().c_str());
+        err("assign");
+    }
+
+    static void assign_error_too_many(const std::size_t expected, const std::size_t got)
+    {
+        std::stringstream msg;
+        msg << "too many values to unpack (expected "
+            << expected << ", got " << got << ")";
+        PyErr_SetString(PyExc_ValueError, msg.str().c_str());
+        err("assign");
+    }
+
+    template <int way, std::size_t i, std::size_t tend, typename ...To>
+    static void one_way_assign(Python from, const std::size_t fend, std::tuple<To&...> to)
+    {
+        if constexpr(way > 0)
+        {
+            // [0, tend] = [0, fend]
+            if constexpr(i == tend)
+                // starred part
+                std::get<i>(to) = static_cast<Python>(from.slice(Python(i)));  // i to fend
+            else
+            {
+                std::get<i>(to) = from[i];
+                one_way_assign<way, i + 1, tend>(from, tend, to);
+            }
+        }
+        else
+        {
+            if constexpr(i == 0)
+                // starred part
+                std::get<0>(to) = static_cast<Python>(from.slice(Python(0), Python(fend + 1))); // 0 to i
+            else
+            {
+                std::get<i>(to) = from[fend];
+                one_way_assign<way, i - 1, tend>(from, fend - 1, to);
+            }
+        }
+    }
+
+    template <std::size_t b, std::size_t e, std::size_t tend, typename ...To>
+    static void two_way_assign(Python from, const std::size_t fend, [[maybe_unused]] std::tuple<To&...> to)
+    {
+        if constexpr(b < e)
+        {
+            constexpr bool bs = is_starred<b, To...>::value;
+            constexpr bool es = is_starred<e, To...>::value;
+
+            // shouldn't raise at all
+            assert((bs && es) == false && "two starred expressions in same assign");
+
+            if (bs == false)
+                std::get<b>(to) = from[b];
+            if (es == false)
+                std::get<e>(to) = from[fend];
+
+            // b is starred (freeze b in position, while e keep going)
+            if constexpr(bs)
+                two_way_assign<b, e - 1, tend>(from, fend - 1, to);
+            // e is starred (freeze e in position, while b keep going)
+            else if constexpr(es)
+                two_way_assign<b + 1, e, tend>(from, fend, to);
+            // no starred (yet) - b and e keep going
+            else
+                two_way_assign<b + 1, e - 1, tend>(from, fend - 1, to);
+        }
+        // slice or odd size
+        if constexpr(b == e)
+        {
+            // starred expression
+            if constexpr(is_starred<b, To...>::value)
+                std::get<b>(to) = from.slice(Python(b), Python(fend + 1));
+            // odd size without starred
+            else if (e == fend)
+                std::get<b>(to) = from[b];
+            else
+                assign_error_not_enough(tend + 1, tend + fend - e + 1);
+        }
+        // even size without slice (fend > e means unequal size for assign)
+        else if (b > e && fend > e)
+            assign_error_too_many(tend + 1, tend + fend - e + 1);
+    }
+
+public:
+    template <typename ...To>
+    static void assign(Python from, To&&... to)
+    {
+        // ensures there is less than 2 starred expressions
+        static_assert(starred_count<To...>::value < 2);
+
+        assert(PyTuple_Check(from) || PyList_Check(from) || PyDict_Check(from));
+
+        // handle dict's case (return keys)
+        from = static_cast<PyObject*>(Starred(from));
+
+        /// Index of last element of to
+        constexpr std::size_t tend = sizeof...(To) - 1;
+        /// Index of last element of from
+        const std::size_t fend = from.size() - 1;
+
+        // starred at begin (*a, b, c)
+        if constexpr(is_starred<0, To...>::value)
+            one_way_assign<-1, tend, tend>(from, fend, std::forward_as_tuple(to...));
+        // starred at end (a, b, *c)
+        else if constexpr(is_starred<tend, To...>::value)
+            one_way_assign<1, 0, tend>(from, fend, std::forward_as_tuple(to...));
+        // starred in-between or none (a, b, c or a, *b, c)
+        else
+            two_way_assign<0, tend, tend>(from, fend, std::forward_as_tuple(to...));
+    }
+
+    bool is_valid(void) const
+    {
+        return ref_;
+    }
+
+    std::string name(void) const
+    {
+        return ref_.name.str();
+    }
+
+    Type get_type(void)
+    {
+        assert(is_valid());
+
+        if (PyDict_Check(ref_))
+            return Type::Dict;
+        else if (PySequence_Check(ref_))
+            return Type::Sequence;
+        else
+            return Type::Object;
+    }
+
+    /*=====  DICT  =====*/
+    /// Return a slice of a Sequence
+    auto slice(Python start = None, Python stop = None, Python step = None)
+    {
+        Python slice_obj = Python(PySlice_New(start, stop, step),
+                                  PYNAME(name() + "["
+                                       + (start == None ? "" : start.name()) + ":"
+                                       + (stop == None ? "" : stop.name()) + ":"
+                                       + (step == None ? "" : step.name()) + "]"));
+
+        return (*this)[slice_obj];
+    }
+
+    /// Return an iterator on the iterable
+    auto iter(void)
+    {
+        assert(is_valid());
+
+        auto ptr = PyObject_GetIter(ref_.ptr);
+        err("iter");
+
+        return Python(ptr, PYNAME(name() + ".__iter__()"));
+    }
+
+    auto next(void)
+    {
+        assert(is_valid() && PyIter_Check(ref_.ptr));
+
+        // the end of the iteration is a NULL without exception
+        auto ptr = PyIter_Next(ref_.ptr);
+        if (ptr == nullptr && PyErr_Occurred() == nullptr)
+            throw StopIteration();
+        else
+            err("next");
+
+        return Python(ptr, PYNAME(name() + ".__next__()"));
+    }
+
+    /// Input iterator for range-based for loops (for (auto item : obj))
+    /// Exact lists and tuples are walked by index, other iterables through __iter__
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Python;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Python;
+
+        /// End of any iteration
+        Iterator(void)
+        {}
+
+        explicit Iterator(const PyRef& iterable)
+        {
+            if (PyList_CheckExact(iterable.ptr) || PyTuple_CheckExact(iterable.ptr))
+                sequence_ = iterable;
+            else
+            {
+                iterator_ = PyRef(PyObject_GetIter(iterable), PYNAME(iterable.name.str() + ".__iter__()"));
+                err("iter");
+
+                ++*this;
+            }
+        }
+
+        Python operator*() const
+        {
+            if (sequence_)
+                return Python(PySequence_Fast_GET_ITEM(sequence_.ptr, index_),
+                              PYNAME(sequence_.name.str() + "[" + std::to_string(index_) + "]"),
+                              PyRef::borrow);
+
+            return Python(item_.ptr, item_.name, PyRef::borrow);
+        }
+
+        Iterator& operator++()
+        {
+            if (sequence_)
+                index_++;
+            // errors may be muted
+            else if (iterator_)
+            {
+                item_ = PyRef(PyIter_Next(iterator_), PYNAME(iterator_.name.str() + ".__next__()"));
+                err("next");
+            }
+
+            return *this;
+        }
+
+        // only the comparison with the end is meaningful
+        bool operator==(const Iterator& o) const
+        {
+            return done() == o.done();
+        }
+
+        bool operator!=(const Iterator& o) const
+        {
+            return done() != o.done();
+        }
+
+    private:
+        bool done(void) const
+        {
+            // the size is read each time, as lists can shrink during the loop
+            if (sequence_)
+                return index_ >= PySequence_Fast_GET_SIZE(sequence_.ptr);
+
+            return item_ == false;
+        }
+
+        PyRef sequence_;
+        Py_ssize_t index_ = 0;
+
+        PyRef iterator_;
+        PyRef item_;
+    };
+
+    Iterator begin(void) const
+    {
+        assert(is_valid());
+
+        return Iterator(ref_);
+    }
+
+    Iterator end(void) const
+    {
+        return Iterator();
+    }
+
+    /// Return the size of an object (must be an iterable)
+    Py_ssize_t size(void) const
+    {
+        assert(is_valid());
+
+        auto ret = PyObject_Size(ref_.ptr);
+        err("size");
+
+        return ret;
+    }
+
+    /// Return current dict's keys (iterable in place, converts to a list)
+    DictView<DictPart::Keys> keys(void) const
+    {
+        return DictView<DictPart::Keys>(ref_);
+    }
+
+    /// Return current dict's values (iterable in place, converts to a list)
+    DictView<DictPart::Values> values(void) const
+    {
+        return DictView<DictPart::Values>(ref_);
+    }
+
+    /// Return current dict's (key, value) pairs, for (auto [key, value] : dict.items())
+    DictView<DictPart::Items> items(void) const
+    {
+        return DictView<DictPart::Items>(ref_);
+    }
+
+    /// Item \var key of a dict, mapping or sequence, std::nullopt if missing (KeyError or IndexError)
+    /// No exception is created on a miss, other errors are raised
+    std::optional<Python> get(Python key) const
+    {
+        assert(is_valid() && key.is_valid());
+
+        PyObject* ptr = nullptr;
+        if (PyDict_Check(ref_.ptr))
+        {
+            // borrowed, the miss sets no error
+            ptr = PyDict_GetItemWithError(ref_.ptr, key);
+            Py_XINCREF(ptr);
+        }
+        else
+        {
+            ptr = PyObject_GetItem(ref_.ptr, key);
+            if (ptr == nullptr && (PyErr_ExceptionMatches(PyExc_KeyError) || PyErr_ExceptionMatches(PyExc_IndexError)))
+                PyErr_Clear();
+        }
+        err("get");
+
+        if (ptr == nullptr)
+            return std::nullopt;
+
+        return Python(ptr, PYNAME(name() + "[" + key.name() + "]"));
+    }
+
+    std::optional<Python> get(const Key& key) const
+    {
+        return get(Python(key, "key", PyRef::borrow));
+    }
+
+    /*===== OBJECT =====*/
+    /// Attribute \var key of the object, std::nullopt if missing (AttributeError)
+    /// No exception is created on a miss, other errors are raised
+    std::optional<Python> get_attr(const Key& key) const
+    {
+        assert(is_valid());
+
+        PyObject* ptr = nullptr;
+
+        # if PY_VERSION_HEX >= 0x030D0000
+            PyObject_GetOptionalAttr(ref_.ptr, key, &ptr);
+        # else
+            ptr = PyObject_GetAttr(ref_.ptr, key);
+            if (ptr == nullptr && PyErr_ExceptionMatches(PyExc_AttributeError))
+                PyErr_Clear();
+        # endif
+        err("get_attr");
+
+        if (ptr == nullptr)
+            return std::nullopt;
+
+        return Python(ptr, PYNAME(name() + "." + key.str()));
+    }
+
+    /// Return true if the object has attribute \var name
+    bool hasattr(const std::string& name)
+    {
+        assert(is_valid());
+
+        auto ret = PyObject_HasAttrString(ref_, name.c_str());
+        err("hasattr");
+
+        return ret;
+    }
+
+    /// Get attribute of object (it's the only way to get attributes of iterables)
+    # define ATTR(TYPE) auto attr(TYPE key)             \
+    {                                                   \
+        assert(is_valid());                             \
+        return PyIndexProxy(ref_, Type::Object, key);   \
+    }
+    ATTR(const std::string&)
+    ATTR(const Key&)
+    ATTR(Python&)
+
+    /// Delete the attribute \var name of the current object
+    bool delattr(const std::string& name)
+    {
+        assert(is_valid());
+
+        auto ret = PyObject_DelAttrString(ref_, name.c_str()) + 1;
+        err("delattr");
+
+        return ret;
+    }
+
+    /// Print the object on the file \var fp, print the representation if \var repr is True
+    void print(const bool repr = false, FILE* fp = stdout) const
+    {
+        PyObject_Print(ref_.ptr, fp, repr ? Py_PRINT_RAW : 0);
+        fprintf(fp, "\n");
+        err("print");
+    }
+
+    /*===== LOOKUP CACHE =====*/
+private:
+    /// Table deciding the result of a lookup (a module dict or a type), with its version at that time
+    struct LookupGuard
+    {
+        PyRef table;
+        std::uint64_t version;
+    };
+
+    /// Return true if \var dict is the dict of a module of sys.modules
+    static bool is_module_dict(PyObject* dict)
+    {
+        static const char literal[] = "__name__";
+        auto name = PyDict_GetItemWithError(dict, Key(literal, sizeof(literal) - 1));
+        auto module = name ? PyDict_GetItemWithError(PyImport_GetModuleDict(), name) : nullptr;
+        PyErr_Clear();
+
+        return module && PyModule_Check(module) && PyModule_GetDict(module) == dict;
+    }
+
+    /// Table deciding \var value, the value of \var key in \var o (nullptr if it can't be cached)
+    /// Only the plain items of module dicts, module globals and class attributes are cached,
+    /// the other dicts and objects (and the results of __getattr__ or descriptors) are not
+    static PyObject* lookup_table(PyObject* o, PyObject* key, PyObject* value)
+    {
+        PyObject* table = nullptr;
+        PyObject* item = nullptr;
+
+        if (PyDict_CheckExact(o))
+        {
+            table = is_module_dict(o) ? o : nullptr;
+            item = value;
+        }
+        else if (PyModule_CheckExact(o))
+        {
+            table = PyModule_GetDict(o);
+            item = PyDict_GetItemWithError(table, key);
+        }
+        else if (Py_IS_TYPE(o, &PyType_Type))
+        {
+            table = o;
+            item = _PyType_Lookup(reinterpret_cast<PyTypeObject*>(o), key);
+        }
+
+        PyErr_Clear();
+        return item == value ? table : nullptr;
+    }
+
+    # if PY_VERSION_HEX >= 0x030C0000
+    static int on_dict_event(PyDict_WatchEvent event, PyObject* dict, PyObject*, PyObject*)
+    {
+        auto& changes = cache_->dict_changes;
+
+        auto found = changes.find(dict);
+        if (found == changes.end())
+            return 0;
+
+        if (event == PyDict_EVENT_DEALLOCATED)
+            changes.erase(found);
+        else
+            found->second++;
+
+        return 0;
+    }
+
+    /// Watch the dict \var table, return false if it can't be watched
+    static bool watch(PyObject* table)
+    {
+        auto& watcher = cache_->dict_watcher;
+        if (watcher.has_value() == false)
+        {
+            const int id = PyDict_AddWatcher(on_dict_event);
+            if (id < 0)
+            {
+                // no more watcher available
+                PyErr_Clear();
+                return false;
+            }
+
+            watcher = id;
+        }
+
+        if (PyDict_Watch(*watcher, table) < 0)
+        {
+            PyErr_Clear();
+            return false;
+        }
+
+        // counted from 1, 0 being an unknown version
+        cache_->dict_changes.try_emplace(table, 1);
+        return true;
+    }
+    # endif
+
+    /// Version of the table of \var guard, changed by any modification (0 if unknown)
+    static std::uint64_t table_version(const LookupGuard& guard)
+    {
+        # if PY_VERSION_HEX >= 0x030C0000
+            if (PyDict_Check(guard.table.ptr))
+            {
+                // found by value, the counters go with the cache of the interpreter
+                const auto& changes = cache_->dict_changes;
+                auto found = changes.find(guard.table.ptr);
+                return found == changes.end() ? 0 : found->second;
+            }
+        # else
+            if (PyDict_Check(guard.table.ptr))
+                return reinterpret_cast<PyDictObject*>(guard.table.ptr)->ma_version_tag;
+        # endif
+
+        // the tag of a modified type is reset since python 3.12 (only flagged as invalid before)
+        auto type = reinterpret_cast<PyTypeObject*>(guard.table.ptr);
+        # if PY_VERSION_HEX >= 0x030C0000
+            return type->tp_version_tag;
+        # else
+            return PyType_HasFeature(type, Py_TPFLAGS_VALID_VERSION_TAG) ? type->tp_version_tag : 0;
+        # endif
+    }
+
+    /// Guard of \var table (a version of 0 if it can't be tracked)
+    static LookupGuard guard(PyObject* table)
+    {
+        LookupGuard guard{};
+        guard.table = PyRef(table, "table", PyRef::borrow);
+
+        # if PY_VERSION_HEX >= 0x030C0000
+            if (PyDict_Check(table) && watch(table) == false)
+                return guard;
+        # endif
+
+        guard.version = table_version(guard);
+        return guard;
+    }
+
+    /// Resolve \var keys from \var o (items of dicts, attributes otherwise)
+    /// When \var guards is given, it receives the tables the result depends on,
+    /// and false is returned in \var cacheable if some of them can't be tracked
+    static PyRef resolve(PyObject* o, const std::vector<Key>& keys,
+                         std::vector<LookupGuard>* guards = nullptr, bool* cacheable = nullptr)
+    {
+        PyRef current(o, "lookup", PyRef::borrow);
+        for (const auto& key : keys)
+        {
+            PyObject* value = nullptr;
+            if (PyDict_CheckExact(current))
+            {
+                value = PyDict_GetItemWithError(current, key);
+                if (value == nullptr && PyErr_Occurred() == nullptr)
+                {
+                    // wrapped in a tuple so that tuple keys are not unpacked
+                    auto args = PyTuple_Pack(1, static_cast<PyObject*>(key));
+                    PyErr_SetObject(PyExc_KeyError, args);
+                    Py_XDECREF(args);
+                }
+                Py_XINCREF(value);
+            }
             else
+                value = PyObject_GetAttr(current, key);
+            err("lookup");
+
+            // errors may be muted
+            if (value == nullptr)
+                return PyRef();
+
+            if (guards && *cacheable)
+            {
+                auto table = lookup_table(current, key, value);
+                if (table)
+                    guards->push_back(guard(table));
+
+                *cacheable = table && guards->back().version != 0;
+            }
+
+            current = PyRef(value, "lookup");
+        }
+
+        return current;
+    }
+
+    /// Interned keys of \var path ("a.b.c")
+    static std::vector<Key> split_path(const std::string& path)
+    {
+        std::vector<Key> keys;
+        for (std::size_t start = 0, end = 0; end != std::string::npos; start = end + 1)
+        {
+            end = path.find('.', start);
+            keys.emplace_back(path.substr(start, end - start));
+        }
+
+        return keys;
+    }
+
+public:
+    /// Item \var key of a dict, attribute \var key of other objects (looked up each time, see Lookup)
+    Python lookup(const Key& key) const
+    {
+        assert(is_valid());
+
+        auto ret = resolve(ref_, { key });
+        return Python(ret.ptr, PYNAME(name() + "." + key.str()), PyRef::borrow);
+    }
+
+    /// Object at \var path ("a.b.c") from the current object, each part being looked up like lookup
+    Python path(const std::string& path) const
+    {
+        assert(is_valid());
+
+        auto ret = resolve(ref_, split_path(path));
+        return Python(ret.ptr, PYNAME(name() + "." + path), PyRef::borrow);
+    }
+
+    // NOTE: a handle remembers a single object, use one handle per call site (or per object)
+    /// Cached lookup of a key or a path ("a.b.c", see path) for a call site
+    /// While the same module, module dict or type is given, the result is given back as long as
+    /// the module dicts and types it went through are unchanged (checked by their version)
+    /// Lookups through other objects are done each time, like path
+    /// WARNING: the handle keeps its last object and result alive (until terminate, which drops them)
+    class Lookup
+    {
+    public:
+        explicit Lookup(const Key& key)
+            : path_(key.str()), keys_{ key }
+        {}
+
+        explicit Lookup(const std::string& path)
+            : path_(path), keys_(split_path(path))
+        {}
+
+        Lookup(const Lookup&) = default;
+        Lookup& operator=(const Lookup&) = delete;
+
+        ~Lookup()
+        {
+            if (is_outdated())
+                forget();
+        }
+
+        /// Result of the lookup from \var o
+        Python operator()(const Python& o)
+        {
+            assert(o.is_valid());
+
+            if (is_outdated())
+            {
+                forget();
+                keys_ = split_path(path_);
+            }
+
+            if (o.ref_.ptr == owner_.ptr && is_current())
+                return Python(value_.ptr, PYNAME(o.name() + "." + path_), PyRef::borrow);
+
+            owner_ = PyRef();
+            guards_.clear();
+
+            bool cacheable = true;
+            auto value = resolve(o.ref_, keys_, &guards_, &cacheable);
+            auto ret = Python(value.ptr, PYNAME(o.name() + "." + path_), PyRef::borrow);
+
+            // errors may be muted
+            if (cacheable && value)
             {
-                object_ = proxy.object_;
-                type_ = proxy.type_;
-                key_ = proxy.key_;
+                owner_ = o.ref_;
+                value_ = std::move(value);
             }
 
-            return *this;
+            return ret;
         }
 
-        template <typename T>
-        auto& operator=(T t)
+        /// Forget the cached object and result
+        void clear(void)
         {
-            return operator=(Python(t));
+            if (is_outdated())
+                forget();
+
+            owner_ = PyRef();
+            value_ = PyRef();
+            guards_.clear();
         }
 
-        auto name() const
+    private:
+        /// Return true if the objects of the handle belong to a terminated interpreter
+        bool is_outdated(void) const
         {
-            return object_.name;
+            return epoch_ != lookup_epoch_.load(std::memory_order_relaxed);
         }
 
-        auto key() const
+        /// Drop the objects of a terminated interpreter, without releasing them
+        void forget(void)
         {
-            return key_;
+            owner_.release();
+            value_.release();
+            for (auto& guard : guards_)
+                guard.table.release();
+            guards_.clear();
+            for (auto& key : keys_)
+                key.ref_.release();
+            keys_.clear();
+
+            epoch_ = lookup_epoch_.load(std::memory_order_relaxed);
         }
 
-    // Since we can't overload "operator.()", we need to duck-type our proxy class
-    auto operator[](const std::string& key) { return parent()[key]; }
-    auto operator[](const Py_ssize_t key) { return parent()[key]; }
-    auto call(Python args = nullptr, Python kwargs = nullptr)
-        { return parent().call(args, kwargs); }
-    auto string(void) { return parent().string(); }
-    auto is_valid(void) { return parent().is_valid(); }
-    auto print(void) { return parent().print(); }
-    auto operator()(Python args = nullptr, Python kwargs = nullptr)
-    { return parent()(args, kwargs); }
+        bool is_current(void) const
+        {
+            for (const auto& guard : guards_)
+                if (table_version(guard) != guard.version)
+                    return false;
 
-    private:
-        PyRef object_;
-        Type type_;
-        key_t key_;
+            return true;
+        }
+
+        std::string path_;
+        std::vector<Key> keys_;
+        /// Object and result of the last cacheable lookup, kept alive so that their address stays theirs
+        PyRef owner_;
+        PyRef value_;
+        std::vector<LookupGuard> guards_;
+        std::uint64_t epoch_ = lookup_epoch_.load(std::memory_order_relaxed);
     };
 
-    template <typename key_t>
-    static std::string to_string(PyIndexProxy<key_t>& s) { return s.name() + "[" + to_string(s.key()) + "]"; }
+    /*===== FUNCTION =====*/
+private:
+    /// Debug name of the arguments of a call (empty if names are disabled)
+    template <std::size_t N>
+    static std::string args_name([[maybe_unused]] const std::array<Python, N>& args)
+    {
+        std::string name;
 
-    // Use this with caution, it shouldn't be used in place of another constructor
-    // as you can't trace the source
-    // Don't use with any Py_* function returning a new reference (leaks)
-    Python(PyObject* o)
-        : ref_(o, "PyObject*", true)
-    {}
+        if constexpr(PyName::enabled)
+            for (const auto& arg : args)
+                join_name(name, arg.name());
 
-public:
-    // NOTE: operator[] won't let you access attribute of iterable, you must use attr
-    /// Access operators
-    # define ACCESS(TYPE) auto operator[](TYPE key) \
-    {                                               \
-        assert(is_valid());                         \
-        return PyIndexProxy(ref_, get_type(), key); \
+        return name;
     }
-    ACCESS(const std::string&)
-    ACCESS(const Py_ssize_t)
-    ACCESS(Python)
 
-    /// Release the ressources of the global Python instance
-    static void terminate(void)
+    /// Set a TypeError and return false if one of \var args is NULL (like Python(nullptr))
+    template <std::size_t N>
+    static bool check_args(const std::array<Python, N>& args)
     {
-        Py_Finalize();
-        initialized_ = false;
-    }
+        for (const auto& arg : args)
+        {
+            if (arg.is_valid() == false)
+            {
+                PyErr_SetString(PyExc_TypeError, "NULL object passed as argument");
+                return false;
+            }
+        }
 
-    /// Disable/Enable error raising
-    static void mute_errors(const bool value)
-    {
-        mute_error = value;
+        return true;
     }
 
-    /// Import the module \var name
-    static Python import(const std::string& name)
+public:
+    // NOTE: a tuple is passed as a single argument (like f(t) in python), use call_with to unpack it
+    /// Call the object with \var args as positional arguments (without creating any tuple)
+    template <typename ...Args>
+    Python operator()(Args&&... args)
     {
-        initialize();
-        auto module = Python(PyImport_ImportModule(name.c_str()), name);
-        err("import");
+        assert(is_valid());
 
-        auto dict = PyModule_GetDict(module);
-        err("import");  // a bit careful doesn't hurt, isn't it ?
+        constexpr auto size = sizeof...(Args);
+        std::array<Python, size> objects = { Python(std::forward<Args>(args))... };
+        if (check_args(objects) == false)
+        {
+            err("call");
+            return Python();
+        }
+
+        // the first slot is left to the callee (PY_VECTORCALL_ARGUMENTS_OFFSET)
+        PyObject* stack[size + 1] = { nullptr };
+        for (std::size_t i = 0; i < size; i++)
+            stack[i + 1] = objects[i];
+
+        auto ret = PyObject_Vectorcall(ref_, stack + 1, size | PY_VECTORCALL_ARGUMENTS_OFFSET, nullptr);
+        err("call");
 
-        return Python(dict, "module " + name, true);
+        return Python(ret, PYNAME(name() + "(" + args_name(objects) + ")"));
     }
 
-private:
+    /// Call the method \var method_name with \var args as positional arguments
+    /// (without creating the bound method nor any tuple)
     template <typename ...Args>
-    static auto dict_extractor(Python dict, const std::string& name, const Args&... args)
+    Python method(const Key& method_name, Args&&... args)
     {
-        if constexpr(sizeof...(Args))
-            return std::tuple_cat(std::tuple(dict[name]), dict_extractor(dict, args...));
+        assert(is_valid());
+
+        constexpr auto size = sizeof...(Args);
+        std::array<Python, size> objects = { Python(std::forward<Args>(args))... };
+        if (check_args(objects) == false)
+        {
+            err("method");
+            return Python();
+        }
+
+        // the first slot is left to the callee (PY_VECTORCALL_ARGUMENTS_OFFSET), then self
+        PyObject* stack[size + 2] = { nullptr, ref_ };
+        for (std::size_t i = 0; i < size; i++)
+            stack[i + 2] = objects[i];
+
+        auto ret = PyObject_VectorcallMethod(method_name, stack + 1, (size + 1) | PY_VECTORCALL_ARGUMENTS_OFFSET, nullptr);
+        err("method");
 
-        return std::tuple(dict[name]);
+        return Python(ret, PYNAME(name() + "." + method_name.str() + "(" + args_name(objects) + ")"));
     }
 
-public:
-    /// Import object from the module \var name
+    /// Overload of method for non-interned names (prefer "name"_key)
     template <typename ...Args>
-    static auto from_import(const std::string& name, const Args&... args)
+    Python method(const std::string& method_name, Args&&... args)
     {
-        return dict_extractor(import(name), args...);
+        return method(Key(method_name), std::forward<Args>(args)...);
     }
 
-    /// Return the python builtins
-    static Python builtins(void)
+    /// Call the object with the tuple \var args as arguments and the dict \var kwargs as keywords
+    /// (both optional, like f(*args, **kwargs))
+    Python call(Python args = nullptr, Python kwargs = nullptr)
     {
-        initialize();
+        assert(is_valid());
 
-        auto ptr = PyEval_GetBuiltins();
-        err("builtins");
+        bool tup = args.is_valid();
+
+        if ((tup && PyTuple_Check(args) == false) || (kwargs.is_valid() && PyDict_Check(kwargs) == false))
+        {
+            PyErr_SetString(PyExc_TypeError, "call expects a tuple of arguments and a dict of keywords");
+            err("call");
+            return Python();
+        }
+
+        // no need for an empty tuple without arguments
+        auto ret = tup ? PyObject_Call(ref_, args, kwargs)
+                       : PyObject_VectorcallDict(ref_, nullptr, 0, kwargs);
+        err("call");
+
+        return Python(ret, PyName([&]()
+        {
+            auto nargs = tup ? args.name() : std::string("()");
+            if (kwargs)
+            {
+                nargs.pop_back();       // remove ending parenthesis
 
-        return Python(ptr, "builtins", true);
+                if (tup)                // add "," to make distinction with args
+                    nargs += ", ";
+
+                // add kwargs
+                const auto kwarg = kwargs.name().substr(1, kwargs.name().size() - 2);
+                nargs += kwarg + ")";// std::regex_replace(kwarg, kwargs_regex, "$1 = ") + ")";
+            }
+
+            return name() + nargs;
+        }));
     }
 
-    /// Call a builtin function
-    static Python call_builtin(const std::string& name, Python args = nullptr, Python kwargs = nullptr)
+    /// Call the object with the tuple \var args unpacked as arguments and the dict \var kwargs as keywords
+    /// (the former operator()(args, kwargs))
+    Python call_with(Python args, Python kwargs = nullptr)
     {
-        auto main = builtins();
-        return main[name].call(args, kwargs);
+        return call(args, kwargs);
     }
 
-    /// Evaluate python code
-    static Python eval(const std::string& content, int type, Python globals, Python locals)
+    /// Call the function \var name in object with \var args as arguments and \var kwargs as keywords
+    Python call(const std::string& name, Python args = nullptr, Python kwargs = nullptr)
     {
-        PyObject* ret;
-        globals["__builtins__"] = PyEval_GetBuiltins();
-
-        ret = PyRun_String(content.c_str(), type, globals, locals);
-        err("eval");
+        assert(is_valid());
 
-        return Python(ret, "eval");
+        return attr(name).call(args, kwargs);
     }
 
+    /*===== BUFFER =====*/
 private:
-    /// Assign object \var obj at the ith slot of tuple
-    template <typename T>
-    static std::string tuple_assign(PyObject** ptr, std::size_t& i, T t)
+    /// Python object exposing C++ memory through the buffer protocol
+    struct BufferExport
     {
-        Python obj = Python(t);
-
-        if constexpr(is_starred<0, T>::value)
+        /// C++ part of the object, constructed in place after the python allocation
+        struct Data
         {
-            /// Target size (size of the container to fill)
-            const std::size_t t_size = PyObject_Size(*ptr);
-            /// Container size (size of the container to get items from)
-            const std::size_t c_size = PyObject_Size(obj);
+            void* buf;
+            Py_ssize_t itemsize;
+            const char* format;
+            bool readonly;
+            std::vector<Py_ssize_t> shape;
+            std::vector<Py_ssize_t> strides;
+            std::shared_ptr<const void> owner;
+        };
+
+        PyObject_HEAD
+        Data data;
+
+        static int getbuffer(PyObject* self, Py_buffer* view, int flags)
+        {
+            auto& data = reinterpret_cast<BufferExport*>(self)->data;
 
-            _PyTuple_Resize(ptr, t_size + c_size - 1);
-            err("tuple");
+            Py_ssize_t len = data.itemsize;
+            for (auto dim : data.shape)
+                len *= dim;
 
-            for (std::size_t index = 0; index < c_size; index++, i++)
-                PyTuple_SetItem(*ptr, i, PySequence_GetItem(obj, index));
-            err("tuple");
+            // without format, the items of a shaped buffer would be read as unsigned bytes
+            const bool bytes = data.format[0] == 'B' && data.format[1] == '\0';
+            if ((flags & PyBUF_ND) == PyBUF_ND && (flags & PyBUF_FORMAT) == 0 && bytes == false)
+            {
+                PyErr_Format(PyExc_BufferError, "the format '%s' of the items must be requested (PyBUF_FORMAT)",
+                             data.format);
+                view->obj = nullptr;
+                return -1;
+            }
 
-            return std::string("*") + obj.name();
-        }
-        else
-        {
-            Py_INCREF(obj);
-            PyTuple_SetItem(*ptr, i++, obj);
-            err("tuple");
+            // handle the read-only check and the flat (PyBUF_SIMPLE) case
+            if (PyBuffer_FillInfo(view, self, data.buf, len, data.readonly, flags) == -1)
+                return -1;
 
-            return obj.name();
+            // the format is given only when requested (NULL meaning unsigned bytes otherwise)
+            if (flags & PyBUF_FORMAT)
+            {
+                view->format = const_cast<char*>(data.format);
+                view->itemsize = data.itemsize;
+            }
+            if ((flags & PyBUF_ND) == PyBUF_ND)
+            {
+                view->ndim = data.shape.size();
+                view->shape = data.shape.data();
+            }
+            if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES)
+                view->strides = data.strides.data();
+
+            return 0;
         }
-    }
 
-    /// Collect the arguments of a C++ tuple to put them in a python tuple
-    template <std::size_t pos, typename ...Args>
-    static std::string tuple_caller(PyObject** ptr, std::size_t& i, const std::tuple<Args...>& args)
-    {
-        std::string name;
+        static void dealloc(PyObject* self)
+        {
+            auto type = Py_TYPE(self);
 
-        if constexpr(pos == 0)
-            name = tuple_assign(ptr, i, std::get<pos>(args));
-        else
-            name = ", " + tuple_assign(ptr, i, std::get<pos>(args));
+            reinterpret_cast<BufferExport*>(self)->data.~Data();
+            type->tp_free(self);
 
-        if constexpr(pos + 1 < sizeof...(Args))
-            name += tuple_caller<pos + 1>(ptr, i, args);
+            // instances of heap types own a reference to their type
+            Py_DECREF(type);
+        }
 
-        return name;
-    }
+        static PyTypeObject* type(void)
+        {
+            if (cache_->buffer_type == false)
+            {
+                static PyType_Slot slots[] =
+                {
+                    { Py_tp_dealloc,    reinterpret_cast<void*>(dealloc) },
+                    { Py_bf_getbuffer,  reinterpret_cast<void*>(getbuffer) },
+                    { 0,                nullptr },
+                };
+                static PyType_Spec spec =
+                {
+                    "python_hh.Buffer", sizeof(BufferExport), 0, Py_TPFLAGS_DEFAULT, slots
+                };
+
+                cache_->buffer_type = PyRef(PyType_FromSpec(&spec), "python_hh.Buffer");
+                err("buffer");
+            }
+
+            return reinterpret_cast<PyTypeObject*>(cache_->buffer_type.ptr);
+        }
+    };
 
 public:
-    /// Create a tuple from C++ tuple
-    template <typename ...Args>
-    static Python tuple(const std::tuple<Args...>& args)
+    /// Expose the C-contiguous array \var data of shape \var shape to Python, without copy
+    /// The buffer is read-only if T is const, \var owner is kept alive as long as the python object
+    /// WARNING: without owner, \var data must outlive the python object (and all its views)
+    template <typename T>
+    static Python export_buffer(T* data, const std::vector<Py_ssize_t>& shape,
+                                std::shared_ptr<const void> owner = nullptr)
     {
         initialize();
 
-        constexpr auto size = sizeof...(Args);
-        auto ptr = PyTuple_New(size);
-        err("tuple");
+        auto type = BufferExport::type();
+        auto ptr = type ? type->tp_alloc(type, 0) : nullptr;
+        err("export_buffer");
 
-        if constexpr(sizeof...(Args))
+        // errors may be muted, there is nothing to construct in place
+        if (ptr == nullptr)
+            return Python();
+
+        // C-contiguous strides (last dimension is contiguous)
+        std::vector<Py_ssize_t> strides(shape.size());
+        Py_ssize_t stride = sizeof(T);
+        for (std::size_t i = shape.size(); i > 0; i--)
         {
-            std::size_t i = 0;
-            return Python(ptr, "(" + tuple_caller<0>(&ptr, i, args) + ")");
+            strides[i - 1] = stride;
+            stride *= shape[i - 1];
         }
-        else
-            return Python(ptr, "()");
+
+        using Data = BufferExport::Data;
+        new (&reinterpret_cast<BufferExport*>(ptr)->data) Data
+        {
+            const_cast<typename std::remove_const<T>::type*>(data), sizeof(T), buffer_format<T>(),
+            std::is_const<T>::value, shape, std::move(strides), std::move(owner)
+        };
+
+        return Python(ptr, PYNAME("buffer<" + std::string(buffer_format<T>()) + ">"));
     }
 
-    /// Create a tuple from all the passed arguments
-    template <typename ...Args>
-    static Python tuple(Args... args)
+    /// Expose the vector \var v to Python without copy (writable, \var v must outlive the object)
+    template <typename T>
+    static Python export_buffer(std::vector<T>& v)
     {
-        return tuple(std::tuple(args...));
+        return export_buffer(v.data(), { static_cast<Py_ssize_t>(v.size()) });
     }
 
-    /// Create a tuple from C++ iterable
-    template <typename Iterable>
-    static Python tuple(const Iterable& iter)
+    /// Expose the vector \var v to Python without copy (read-only, \var v must outlive the object)
+    template <typename T>
+    static Python export_buffer(const std::vector<T>& v)
     {
-        static_assert(is_iterable<Iterable>::value);
-
-        initialize();
-
-        auto ptr = PyTuple_New(iter.size());
-        err("tuple");
-
-        std::string name;
-
-        std::size_t i = 0;
-        for (auto&& e : iter)
-        {
-            if (i > 0)
-                name += ", ";
-
-            name += tuple_assign(&ptr, i,  e);
-        }
+        return export_buffer(v.data(), { static_cast<Py_ssize_t>(v.size()) });
+    }
 
-        return Python(ptr, "[" + name + "]");
+    /// Move the vector \var v into a python object exposing it without copy (writable)
+    template <typename T>
+    static Python export_buffer(std::vector<T>&& v)
+    {
+        auto owner = std::make_shared<std::vector<T>>(std::move(v));
+        return export_buffer(owner->data(), { static_cast<Py_ssize_t>(owner->size()) }, owner);
     }
 
-    /// Create a tuple from python iterable
-    static Python tuple(Python o)
+    /// Expose the shared vector \var v without copy, keeping it alive as long as the python object
+    template <typename T>
+    static Python export_buffer(const std::shared_ptr<std::vector<T>>& v)
     {
-        assert(o.is_valid());
+        return export_buffer(v->data(), { static_cast<Py_ssize_t>(v->size()) }, v);
+    }
 
-        auto ptr = PySequence_Tuple(o);
-        err("tuple");
+    /// Expose the array \var a to Python without copy (writable, \var a must outlive the object)
+    template <typename T, std::size_t N>
+    static Python export_buffer(std::array<T, N>& a)
+    {
+        return export_buffer(a.data(), { static_cast<Py_ssize_t>(N) });
+    }
 
-        return Python(ptr, "tuple(" + o.name() + ")" );
+    /// Expose the array \var a to Python without copy (read-only, \var a must outlive the object)
+    template <typename T, std::size_t N>
+    static Python export_buffer(const std::array<T, N>& a)
+    {
+        return export_buffer(a.data(), { static_cast<Py_ssize_t>(N) });
     }
 
 private:
-    /// Assign object \var obj at the ith slot of list
-    template <typename T>
-    static std::string list_assign(PyObject* ptr, T t)
+    /// Check if \var C is a contiguous container of bytes (std::string, std::vector<std::byte>, std::span...)
+    template <typename C>
+    using is_byte_container = std::conjunction<std::is_class<C>, std::bool_constant<
+        sizeof(*std::data(std::declval<C&>())) == 1>>;
+
+public:
+    /// Create bytes from a copy of the \var size bytes at \var data
+    static Python bytes(const void* data, const std::size_t size)
     {
-        Python obj = Python(t);
+        initialize();
 
-        if constexpr(is_starred<0, T>::value)
-        {
-            /// Container size (size of the container to get items from)
-            const std::size_t c_size = PyObject_Size(obj);
-            for (std::size_t index = 0; index < c_size; index++)
-                PyList_Append(ptr, PySequence_GetItem(obj, index));
-            err("list");
+        auto ptr = PyBytes_FromStringAndSize(static_cast<const char*>(data), size);
+        err("bytes");
 
-            return std::string("*") + obj.name();
-        }
-        else
-        {
-            Py_INCREF(obj);
-            PyList_Append(ptr, obj);
-            err("list");
+        return Python(ptr, PYNAME("bytes[" + std::to_string(size) + "]"));
+    }
 
-            return obj.name();
-        }
+    /// Create bytes from a copy of \var str (without its final null character)
+    static Python bytes(const std::string_view str)
+    {
+        return bytes(str.data(), str.size());
     }
 
-    /// Collect the arguments of a C++ tuple to put them in a python list
-    template <std::size_t pos, typename ...Args>
-    static std::string list_caller(PyObject* ptr, const std::tuple<Args...>& args)
+    /// Create bytes from a copy of the contiguous container of bytes \var c
+    template <typename C, typename = std::enable_if_t<is_byte_container<C>::value>>
+    static Python bytes(const C& c)
     {
-        std::string name;
+        return bytes(std::data(c), std::size(c));
+    }
 
-        if constexpr(pos == 0)
-            name = list_assign(ptr, std::get<pos>(args));
-        else
-            name = ", " + list_assign(ptr, std::get<pos>(args));
+    /// Create bytes of \var size bytes, written in place by \var fill(char* data, std::size_t size)
+    template <typename F, typename = std::enable_if_t<std::is_invocable<F&, char*, std::size_t>::value>>
+    static Python bytes(const std::size_t size, F&& fill)
+    {
+        initialize();
 
-        if constexpr(pos + 1 < sizeof...(Args))
-            name += list_caller<pos + 1>(ptr, args);
+        // bytes are immutable once shared, they can only be written before that
+        auto ptr = PyBytes_FromStringAndSize(nullptr, size);
+        err("bytes");
 
-        return name;
+        auto obj = Python(ptr, PYNAME("bytes[" + std::to_string(size) + "]"));
+        fill(PyBytes_AS_STRING(ptr), size);
+
+        return obj;
     }
 
-public:
-    /// Create a list from C++ tuple
-    template <typename ...Args>
-    static Python list(const std::tuple<Args...>& args)
+    /// Create a bytearray from a copy of the \var size bytes at \var data
+    static Python bytearray(const void* data, const std::size_t size)
     {
         initialize();
 
-        auto ptr = PyList_New(0);
-        err("list");
+        auto ptr = PyByteArray_FromStringAndSize(static_cast<const char*>(data), size);
+        err("bytearray");
 
-        if constexpr(sizeof...(Args))
-            return Python(ptr, "[" + list_caller<0>(ptr, args) + "]");
-        else
-            return Python(ptr, "[]");
+        return Python(ptr, PYNAME("bytearray[" + std::to_string(size) + "]"));
     }
 
-    /// Create a list from all the passed arguments
-    template <typename ...Args>
-    static Python list(Args... args)
+    static Python bytearray(const std::string_view str)
     {
-        return list(std::tuple(args...));
+        return bytearray(str.data(), str.size());
     }
 
-    /// Create a list from C++ iterable
-    template <typename Iterable>
-    static Python list(const Iterable& iter)
+    /// Create a bytearray from a copy of the contiguous container of bytes \var c
+    template <typename C, typename = std::enable_if_t<is_byte_container<C>::value>>
+    static Python bytearray(const C& c)
     {
-        static_assert(is_iterable<Iterable>::value);
+        return bytearray(std::data(c), std::size(c));
+    }
 
+    /// Read-only memoryview on the \var size bytes at \var data, without copy
+    /// WARNING: \var data must outlive the memoryview (and the objects using it)
+    static Python memoryview(const void* data, const std::size_t size)
+    {
         initialize();
 
-        auto ptr = PyList_New(0);
-        err("list");
+        auto ptr = PyMemoryView_FromMemory(const_cast<char*>(static_cast<const char*>(data)), size, PyBUF_READ);
+        err("memoryview");
 
-        std::string name;
+        return Python(ptr, PYNAME("memoryview[" + std::to_string(size) + "]"));
+    }
 
-        bool first = false;
-        for (auto&& e : iter)
-        {
-            if (first)
-                name += ", ";
+    /// Writable memoryview on the \var size bytes at \var data, without copy
+    /// WARNING: \var data must outlive the memoryview (and the objects using it)
+    static Python memoryview(void* data, const std::size_t size)
+    {
+        initialize();
 
-            name += list_assign(ptr,  e);
-            first = true;
-        }
+        auto ptr = PyMemoryView_FromMemory(static_cast<char*>(data), size, PyBUF_WRITE);
+        err("memoryview");
 
-        return Python(ptr, "[" + name + "]");
+        return Python(ptr, PYNAME("memoryview[" + std::to_string(size) + "]"));
     }
 
-    /// Create a list from python iterable
-    static Python list(Python o)
+    /// Memoryview on the contiguous container of bytes \var c, without copy
+    /// (read-only if \var c is const, see the warning above)
+    template <typename C, typename = std::enable_if_t<is_byte_container<std::remove_reference_t<C>>::value>>
+    static Python memoryview(C&& c)
+    {
+        static_assert(std::is_rvalue_reference<C&&>::value == false, "the container must outlive the memoryview");
+
+        return memoryview(std::data(c), std::size(c));
+    }
+
+    /// Memoryview on any object implementing the buffer protocol
+    static Python memoryview(Python o)
     {
         assert(o.is_valid());
 
-        auto ptr = PySequence_List(o);
-        err("list");
+        auto ptr = PyMemoryView_FromObject(o);
+        err("memoryview");
 
-        return Python(ptr, "list(" + o.name() + ")" );
+        return Python(ptr, PYNAME("memoryview(" + o.name() + ")"));
     }
 
-private:
-    /// Collect the args (key, value pairs) and put them into the dict
-    template <typename K, typename T, typename ...Args>
-    static std::string dict_assign(Python& dict, K k, T i, Args... items)
+    /// RAII view on the memory of an object implementing the buffer protocol (bytes, array, numpy...)
+    /// Use a const \var T for read-only access, a mutable one requires a writable buffer
+    template <typename T>
+    class BufferView
     {
-        assert(dict.is_valid());
+    public:
+        explicit BufferView(PyObject* obj)
+        {
+            static_assert(buffer_format<T>() != nullptr);
 
-        auto key = Python(k);
-        auto item = Python(i);
+            const int flags = std::is_const<T>::value ? PyBUF_RECORDS_RO : PyBUF_RECORDS;
+            if (PyObject_GetBuffer(obj, &view_, flags) == 0 && check_format() == false)
+                release();
 
-        dict[key] = item;
-        err("dict");
+            err("buffer");
+        }
 
-        std::string name = key.ref_.name + ": " + item.ref_.name;
+        BufferView(BufferView&& o) noexcept
+            : view_(o.view_)
+        {
+            o.view_.obj = nullptr;
+        }
 
-        if constexpr(sizeof...(Args))
-            name += ", " + dict_assign(dict, items...);
+        BufferView(const BufferView&) = delete;
+        BufferView& operator=(const BufferView&) = delete;
 
-        return name;
-    }
+        ~BufferView()
+        {
+            release();
+        }
 
-    /// Overload of dict_assign for pair
-    template <typename K, typename T>
-    static std::string dict_assign(Python& dict, const std::pair<K, T>& p)
-    {
-        assert(dict.is_valid());
+        /// Start of the buffer
+        T* data(void) const
+        {
+            return static_cast<T*>(view_.buf);
+        }
 
-        auto key = Python(p.first);
-        auto item = Python(p.second);
+        /// Number of items
+        std::size_t size(void) const
+        {
+            return view_.itemsize ? view_.len / view_.itemsize : 0;
+        }
 
-        dict[key] = item;
-        err("dict");
+        std::size_t ndim(void) const
+        {
+            return view_.ndim;
+        }
 
-        return key.ref_.name + ": " + item.ref_.name;
-    }
+        /// Number of items in the dimension \var dim
+        Py_ssize_t shape(const std::size_t dim) const
+        {
+            assert(dim < ndim());
+            return view_.shape[dim];
+        }
 
-public:
-    /// Create a dictionnary from all the passed objects
-    template <typename ...Args>
-    static Python dict(Args... items)
-    {
-        initialize();
+        /// Number of bytes between two items in the dimension \var dim
+        Py_ssize_t stride(const std::size_t dim) const
+        {
+            assert(dim < ndim());
+            return view_.strides[dim];
+        }
 
-        auto ptr = PyDict_New();
-        err("dict");
+        bool readonly(void) const
+        {
+            return view_.readonly;
+        }
 
-        auto obj = Python(ptr, "dict");
-        if constexpr(sizeof...(Args))
-            obj.ref_.name = dict_assign(obj, items...);
+        /// True if the items are contiguous (then data() can be used as an array)
+        bool contiguous(void) const
+        {
+            return PyBuffer_IsContiguous(&view_, 'C');
+        }
 
-        return obj;
-    }
+        /// Access the item \var i of a one-dimensional buffer (strided)
+        T& operator[](const Py_ssize_t i) const
+        {
+            assert(ndim() == 1 && i < shape(0));
+            return *reinterpret_cast<T*>(static_cast<char*>(view_.buf) + i * view_.strides[0]);
+        }
 
-    /// Overload of dict for iterable
-    template <typename Iterable>
-    static Python dict(const Iterable& i)
-    {
-        static_assert(is_iterable<Iterable>::value);
+        /// Access the item at \var indices (one per dimension) of the buffer (strided)
+        template <typename ...Indices>
+        T& operator()(const Indices... indices) const
+        {
+            assert(sizeof...(Indices) == ndim());
 
-        initialize();
+            const Py_ssize_t index[] = { static_cast<Py_ssize_t>(indices)... };
+            auto ptr = static_cast<char*>(view_.buf);
+            for (std::size_t dim = 0; dim < sizeof...(Indices); dim++)
+                ptr += index[dim] * view_.strides[dim];
 
-        auto ptr = PyDict_New();
-        err("dict");
+            return *reinterpret_cast<T*>(ptr);
+        }
 
-        auto obj = Python(ptr, "dict");
+        // iteration over contiguous buffers
+        T* begin(void) const
+        {
+            assert(contiguous());
+            return data();
+        }
 
-        bool first = true;
-        for (const auto& e : i)
+        T* end(void) const
         {
-            if (first == false)
-                obj.ref_.name += ", ";
+            return begin() + size();
+        }
 
-            obj.ref_.name += dict_assign(obj, e);
-            first = false;
+        # ifdef __cpp_lib_span
+        /// Items of a contiguous buffer
+        std::span<T> span(void) const
+        {
+            assert(contiguous());
+            return std::span<T>(data(), size());
         }
+        # endif
 
-        return obj;
-    }
+    private:
+        /// Kind of a format character: 'i' for signed, 'u' for unsigned, 'f' for floatant, '?' for bool
+        static char format_kind(const char c)
+        {
+            switch (c)
+            {
+                case 'b': case 'h': case 'i': case 'l': case 'q': case 'n': return 'i';
+                case 'B': case 'H': case 'I': case 'L': case 'Q': case 'N': case 'c': return 'u';
+                case 'e': case 'f': case 'd': return 'f';
+                case '?': return '?';
+                default: return 0;
+            }
+        }
 
-    /// Create a dictionnary from passed \var keys iterable and \var values iterable
-    static Python dict(Python keys, Python values)
-    {
-        assert(keys.size() == values.size());
+        /// Check the format and the item size of the buffer against T (TypeError if incompatible)
+        bool check_format(void)
+        {
+            // no format means unsigned bytes
+            const char* format = view_.format ? view_.format : "B";
 
-        auto ptr = PyDict_New();
-        err("dict");
+            // native byte order and alignment
+            if (*format == '@' || *format == '=')
+                format++;
 
-        auto obj = Python(ptr, "dict(keys = " + keys.name() + ", values = " + values.name() + ")");
+            const auto expected = format_kind(*buffer_format<T>());
+            const auto kind = format_kind(*format);
 
-        const std::size_t size = keys.size();
-        for (std::size_t i = 0; i < size; i++)
-            obj[static_cast<Python>(keys[i])] = values[i];
+            // byte-likes (char, std::byte) can view any kind of bytes
+            const bool bytes = sizeof(T) == 1 && expected == 'u' && (kind == 'i' || kind == 'u');
 
-        return obj;
-    }
+            if (format[0] && format[1] == 0 && view_.itemsize == sizeof(T) && (kind == expected || bytes))
+                return true;
 
-    /// Create a set from the iterable \var o
-    static Python set(Python o)
-    {
-        assert(PyTuple_Check(o) || PyList_Check(o));
+            PyErr_Format(PyExc_TypeError, "buffer of format '%s' (item size %zd) can't be viewed as '%s'",
+                         view_.format ? view_.format : "B", view_.itemsize, buffer_format<T>());
 
-        auto ptr = PySet_New(o);
-        err("set");
+            return false;
+        }
 
-        return Python(ptr, "set(" + o.name() + ")");
-    }
+        void release(void)
+        {
+            if (view_.obj)
+                PyBuffer_Release(&view_);
 
-    /*===== CONSTRUCTORS =====*/
-    template <typename A, typename B>
-    Python(const std::pair<A, B>& p)
-    {
-        *this = tuple(p.first, p.second);
-        assert(is_valid());
-    }
+            view_.obj = nullptr;
+        }
 
-    template <typename T>
-    Python(const std::vector<T>& v)
-    {
-        *this = list(v);
-        assert(is_valid());
-    }
+        Py_buffer view_ = {};
+    };
 
-    // avoid ambiguouty with vector-like (like string) structures and vector
+    /// View the memory of the object as an array of \var T, without copy (see BufferView)
     template <typename T>
-    Python(const std::initializer_list<T>& v)
+    BufferView<T> buffer(void)
     {
-        *this = list(v);
         assert(is_valid());
-    }
 
-    template <typename T, std::size_t N>
-    Python(const std::array<T, N>& v)
-    {
-        *this = list(v);
-        assert(is_valid());
+        return BufferView<T>(ref_.ptr);
     }
 
-    template <typename T>
-    Python(const std::list<T>& v)
+    /*===== STREAM =====*/
+private:
+    /// Python iterator pulling its items from a C++ producer, one at a time (or by chunk)
+    struct StreamExport
     {
-        *this = list(v);
-        assert(is_valid());
-    }
+        /// Producer of the items, holding any callable (move-only ones too)
+        struct Producer
+        {
+            virtual ~Producer() = default;
 
-    template <typename K, typename T>
-    Python(const std::map<K, T>& v)
-    {
-        *this = dict(v);
-        assert(is_valid());
-    }
+            /// New reference to the next item, NULL without exception at the end
+            virtual PyObject* next(void) = 0;
+        };
 
-    template <typename ...Args>
-    Python(const std::tuple<Args...>& v)
-    {
-        *this = tuple(v);
-        assert(is_valid());
-    }
+        template <typename F>
+        struct ProducerOf : Producer
+        {
+            explicit ProducerOf(F&& f)
+                : func(std::move(f))
+            {}
 
-    template <typename T>
-    Python(const std::optional<T>& t)
-    {
-        if (t.has_value())
-            *this = Python(t.value());
-        else
-            *this = None;
-    }
+            PyObject* next(void) override
+            {
+                return func();
+            }
 
-    // Generic constructor working with any type of string (as long as python support them)
-    template <typename charT>
-    Python(const std::basic_string<charT>& t)
+            F func;
+        };
+
+        template <typename F>
+        static std::unique_ptr<Producer> make_producer(F&& f)
+        {
+            return std::make_unique<ProducerOf<std::decay_t<F>>>(std::forward<F>(f));
+        }
+
+        /// C++ part of the object, constructed in place after the python allocation
+        struct Data
+        {
+            std::unique_ptr<Producer> producer;
+            /// Number of items per __next__ (as a list), 0 to yield them one by one
+            std::size_t chunk;
+        };
+
+        PyObject_HEAD
+        Data data;
+
+        /// Call the producer, turning C++ exceptions into python ones
+        static PyObject* pull(Data& data)
+        {
+            // the producer is released at the end, and never called again
+            if (data.producer == nullptr)
+                return nullptr;
+
+            try
+            {
+                auto ptr = data.producer->next();
+                if (ptr == nullptr && PyErr_Occurred() == nullptr)
+                    data.producer.reset();
+
+                return ptr;
+            }
+            catch (PythonError& e)
+            {
+                e.restore();
+            }
+            catch (const std::exception& e)
+            {
+                PyErr_SetString(PyExc_RuntimeError, e.what());
+            }
+            catch (...)
+            {
+                PyErr_SetString(PyExc_RuntimeError, "unknown C++ exception in the producer");
+            }
+
+            return nullptr;
+        }
+
+        static PyObject* iternext(PyObject* self)
+        {
+            auto& data = reinterpret_cast<StreamExport*>(self)->data;
+
+            if (data.chunk == 0)
+                return pull(data);
+
+            auto list = PyList_New(0);
+            if (list == nullptr)
+                return nullptr;
+
+            for (std::size_t i = 0; i < data.chunk; i++)
+            {
+                auto item = pull(data);
+                if (item == nullptr)
+                    break;
+
+                const auto ret = PyList_Append(list, item);
+                Py_DECREF(item);
+
+                if (ret == -1)
+                    break;
+            }
+
+            // a partial chunk is returned at the end, but dropped on error
+            if (PyErr_Occurred() || PyList_GET_SIZE(list) == 0)
+            {
+                Py_DECREF(list);
+                return nullptr;
+            }
+
+            return list;
+        }
+
+        static void dealloc(PyObject* self)
+        {
+            auto type = Py_TYPE(self);
+
+            reinterpret_cast<StreamExport*>(self)->data.~Data();
+            type->tp_free(self);
+
+            // instances of heap types own a reference to their type
+            Py_DECREF(type);
+        }
+
+        static PyTypeObject* type(void)
+        {
+            if (cache_->stream_type == false)
+            {
+                static PyType_Slot slots[] =
+                {
+                    { Py_tp_dealloc,    reinterpret_cast<void*>(dealloc) },
+                    { Py_tp_iter,       reinterpret_cast<void*>(PyObject_SelfIter) },
+                    { Py_tp_iternext,   reinterpret_cast<void*>(iternext) },
+                    { 0,                nullptr },
+                };
+                static PyType_Spec spec =
+                {
+                    "python_hh.Stream", sizeof(StreamExport), 0, Py_TPFLAGS_DEFAULT, slots
+                };
+
+                cache_->stream_type = PyRef(PyType_FromSpec(&spec), "python_hh.Stream");
+                err("stream");
+            }
+
+            return reinterpret_cast<PyTypeObject*>(cache_->stream_type.ptr);
+        }
+    };
+
+public:
+    /// Lazy python iterator over \var source, converting the items when python asks for them
+    /// \var source is either a C++ range (moved in if temporary) or a callable returning
+    /// std::optional items (std::nullopt ends the iteration)
+    /// With a \var chunk size, each step gives a list of (at most) \var chunk items
+    /// WARNING: a range passed by reference must outlive the python object
+    template <typename Source>
+    static Python stream(Source&& source, const std::size_t chunk = 0)
     {
         initialize();
-        ref_ = PyRef(PyUnicode_FromKindAndData(sizeof(charT), t.c_str(), t.size()), "\"" + to_string(t) + "\"");
-        err("Python");
-    }
 
-    template <typename charT>
-    explicit Python(const charT* t)
-        : Python(std::basic_string<charT>(t))
-    {
-        static_assert(std::is_same<charT, char>::value
-                   || std::is_same<charT, wchar_t>::value
-                   || std::is_same<charT, char16_t>::value
-                   || std::is_same<charT, char32_t>::value);
-    }
+        std::unique_ptr<StreamExport::Producer> producer;
 
-    template <typename T>
-    Python(PyIndexProxy<T> t)
-    {
-        *this = t;
-    }
+        if constexpr(std::is_invocable<Source&>::value == false)
+        {
+            // a temporary range is stored by value, a named one by reference
+            struct State
+            {
+                Source range;
+                std::optional<decltype(std::begin(std::declval<Source&>()))> it;
+            };
+
+            auto state = std::make_shared<State>(State{ std::forward<Source>(source), std::nullopt });
+            producer = StreamExport::make_producer([state]() -> PyObject*
+            {
+                // begin as late as possible, for the ranges doing work in begin()
+                if (state->it.has_value() == false)
+                    state->it.emplace(std::begin(state->range));
+
+                auto& it = *state->it;
+                if (it == std::end(state->range))
+                    return nullptr;
+
+                auto ptr = new_reference(*it);
+                ++it;
+
+                return ptr;
+            });
+        }
+        else
+        {
+            producer = StreamExport::make_producer([func = std::forward<Source>(source)]() mutable -> PyObject*
+            {
+                auto item = func();
+                if (item.has_value() == false)
+                    return nullptr;
 
-    template <typename T>
-    Python(Starred<T> t)
-    {
-        *this = t;
-    }
+                return new_reference(*item);
+            });
+        }
 
-    Python(const PyRef& ref)
-        : ref_(ref)
-    {}
+        auto type = StreamExport::type();
+        auto ptr = type ? type->tp_alloc(type, 0) : nullptr;
+        err("stream");
 
-    /// Default constructor
-    Python(void)
-    {}
+        // errors may be muted, there is nothing to construct in place
+        if (ptr == nullptr)
+            return Python();
 
-    /// Default constructor for nullptr (seamlessly pass nullptr)
-    Python(std::nullptr_t)
-    {}
+        using Data = StreamExport::Data;
+        new (&reinterpret_cast<StreamExport*>(ptr)->data) Data{ std::move(producer), chunk };
 
-    /// Copy constructor
-    Python(const Python& o)
-        : ref_(o.ref_)
-    {}
+        return Python(ptr, "stream");
+    }
 
-    explicit Python(const std::filesystem::path& t)
+    /*===== MISC =====*/
+    /// Function called before raising an error (for the current thread)
+    static void set_finally(void (*func)())
     {
-        initialize();
-        ref_ = PyRef(PyUnicode_FromKindAndData(sizeof(std::filesystem::path::value_type), t.c_str(), t.string().size()), "\"" + to_string(t) + "\"");
-        err("Python");
+        finally_func = func;
     }
 
-    // unified interface to get rid of ambiguous overloads
-    template <typename T, typename B = typename std::remove_cv<T>::type>
-    explicit Python(const T t)
+private:
+    /// Call \var func with muted errors, giving its result as an std::optional
+    /// (std::nullopt if a python error is pending after it, which is left to the caller)
+    template <typename F>
+    static auto call_muted(F& func)
     {
-        // forbid this contructor to supplant the other ones
-        static_assert(std::is_same<B, PyRef>::value == false
-                   && std::is_same<B, Python>::value == false
-                   && std::is_same<B, std::string>::value == false
-                   && std::is_same<B, std::nullptr_t>::value == false
-                   && std::is_same<B, PyIndexProxy<std::string>>::value == false
-                   && std::is_same<B, PyIndexProxy<Python>>::value == false
-                   && std::is_same<B, PyIndexProxy<Py_ssize_t>>::value == false);
+        using R = std::invoke_result_t<F&>;
 
-        initialize();
-        // char
-        if constexpr(std::is_same<B, char>::value || std::is_same<B, wchar_t>::value || std::is_same<B, char16_t>::value || std::is_same<B, char32_t>::value)
-            ref_ = PyRef(PyUnicode_FromKindAndData(sizeof(B), &t, 1), to_string(t));
-        // floatant
-        else if constexpr(std::is_same<B, float>::value)
-            ref_ = PyRef(PyFloat_FromDouble(t), to_string(t) + "f");
-        else if constexpr(std::is_same<B, double>::value)
-            ref_ = PyRef(PyFloat_FromDouble(t), to_string(t));
-        else if constexpr(std::is_same<B, long double>::value)
-            ref_ = PyRef(PyFloat_FromDouble(t), to_string(t) + "l");
-        // signed
-        else if constexpr(std::is_same<B, Py_ssize_t>::value)
-            ref_ = PyRef(PyLong_FromSsize_t(t), to_string(t) + "ssz");
-        else if constexpr(std::is_same<B, int8_t>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t) + "ss");
-        else if constexpr(std::is_same<B, short>::value || std::is_same<B, int16_t>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t) + "s");
-        else if constexpr(std::is_same<B, int>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t));
-        else if constexpr(std::is_same<B, long>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t) + "l");
-        else if constexpr(std::is_same<B, long long>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t) + "ll");
-        // unsigned
-        else if constexpr(std::is_same<B, std::size_t>::value)
-            ref_ = PyRef(PyLong_FromSize_t(t), to_string(t) + "sz");
-        else if constexpr(std::is_same<B, uint8_t>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t) + "uss");
-        else if constexpr(std::is_same<B, unsigned short>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t) + "us");
-        else if constexpr(std::is_same<B, unsigned int>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t) + "u");
-        else if constexpr(std::is_same<B, unsigned long>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t) + "ul");
-        else if constexpr(std::is_same<B, unsigned long long>::value)
-            ref_ = PyRef(PyLong_FromLong(t), to_string(t) + "ull");
+        // restored even if func throws a C++ exception
+        struct Mute
+        {
+            const bool previous = mute_error;
 
-        // bool was too tedious to let alone because of multiple convertions to it
-        else if constexpr(std::is_same<B, bool>::value)
-            ref_ = t ? True : False;
-        // in case you didn't activate unused variables
-        else throw std::logic_error("Tried to convert unimplemented type to Python type:" + GET_TYPENAME(0));
+            Mute(void) { mute_error = true; }
+            ~Mute() { mute_error = previous; }
+        } mute;
 
-        err("Python");
+        if constexpr(std::is_void<R>::value)
+        {
+            func();
+            return PyErr_Occurred() == nullptr;
+        }
+        else if constexpr(is_instance<R, std::optional>::value)
+        {
+            R ret = func();
+            return PyErr_Occurred() ? R() : ret;
+        }
+        else
+        {
+            std::optional<R> ret(func());
+            if (PyErr_Occurred())
+                ret.reset();
 
-        // verify validity after (they must all be valid)
-        assert(is_valid());
+            return ret;
+        }
     }
 
-    Python(PyObject* ptr, const std::string& name, bool borrowed = false)
-        : ref_(ptr, name, borrowed)
-    {}
-
-    /*===== OPERATORS =====*/
-    /// Copy operator
-    Python& operator=(const Python& o)
+public:
+    // NOTE: inside \var func, a failing call gives an invalid object instead of throwing (like with
+    //       mute_errors), as() on it gives a default value, any other use must check is_valid first
+    /// Call \var func with muted errors, giving std::nullopt (false for void functions) on python errors
+    /// No exception is created: the error is discarded, or fetched in \var error if given
+    /// \var func may return an std::optional itself (like get), which is given as is
+    template <typename F>
+    static auto try_(F&& func, std::optional<PythonError>* error = nullptr)
     {
-        ref_ = o.ref_;
-        return *this;
-    }
+        auto ret = call_muted(func);
 
-    /// Implicit convertion to PyObject*
-    operator PyObject*()
-    {
-        return ref_;
+        if (PyErr_Occurred())
+        {
+            if (error)
+                error->emplace("try_");
+            else
+                PyErr_Clear();
+        }
+
+        return ret;
     }
 
-    Python operator()(Python args = nullptr, Python kwargs = nullptr)
+    /// Same as try_, only for the python errors matching \var type (like PyExc_LookupError),
+    /// the other ones being raised
+    template <typename F>
+    static auto catch_as(PyObject* type, F&& func)
     {
-        return call(args, kwargs);
-    }
+        auto ret = call_muted(func);
 
-    # define COMPARISON(OP, CMP)                                                \
-        Python OP(Python o)                                                     \
-        {                                                                       \
-            assert(is_valid() && o.is_valid());                                 \
-            auto ptr = PyObject_RichCompare(ref_, o, Py_##CMP);                 \
-            err(#OP);                                                           \
-            auto ret = Python(ptr, name() + " " + (#OP + 8) + " " + o.name());  \
-                                                                                \
-            return ret;                                                         \
+        if (auto current = PyErr_Occurred())
+        {
+            if (PyErr_GivenExceptionMatches(current, type))
+                PyErr_Clear();
+            else
+                err("catch_as");
         }
 
-    // Comparison operators
-    COMPARISON(operator<,   LT)
-    COMPARISON(operator<=,  LE)
-    COMPARISON(operator==,  EQ)
-    COMPARISON(operator!=,  NE)
-    COMPARISON(operator>,   GT)
-    COMPARISON(operator>=,  GE)
-
-    # define OPERATION(OP, FUNC)                                        \
-        Python OP(Python o)                                             \
-        {                                                               \
-            assert(is_valid());                                         \
-            auto ret = import("operator")[#FUNC](tuple(ref_, o));  \
-            err(#OP);                                                   \
-            ret.ref_.name = name() + " " + (#OP + 8) + " " + o.name();  \
-                                                                        \
-            return ret;                                                 \
-        }
-
-    // Arithmetic operators
-    OPERATION(operator+, __add__)
-    OPERATION(operator-, __sub__)
-    OPERATION(operator*, __mul__)
-    OPERATION(operator/, __truediv__)
-    OPERATION(operator%, __mod__)
-    OPERATION(operator>>, __rshift__)
-    OPERATION(operator<<, __lshift__)
-    OPERATION(operator&, __and__)
-    OPERATION(operator^, __xor__)
-    OPERATION(operator|, __or__)
+        return ret;
+    }
 
-    // Inplace arithmetic operators
-    // Can't use the __i*__ function, since immutable objets don't handle them
-    Python operator+=(Python o) {   return (*this = *this + o); }
-    Python operator-=(Python o) {   return (*this = *this - o); }
-    Python operator*=(Python o) {   return (*this = *this * o); }
-    Python operator/=(Python o) {   return (*this = *this / o); }
-    Python operator%=(Python o) {   return (*this = *this % o); }
-    Python operator>>=(Python o) {  return (*this = *this >> o); }
-    Python operator<<=(Python o) {  return (*this = *this << o); }
-    Python operator&=(Python o) {   return (*this = *this & o); }
-    Python operator^=(Python o) {   return (*this = *this ^ o); }
-    Python operator|=(Python o) {   return (*this = *this | o); }
+    /// Same as try_, only for the python errors of the error class \var E (like catch_as<KeyError>),
+    /// or of its subclasses in python
+    template <typename E, typename F>
+    static auto catch_as(F&& func)
+    {
+        return catch_as(E::type(), std::forward<F>(func));
+    }
 
-    /*===== MISC =====*/
-    Python contains(Python o)
+    /*===== CONVERSIONS =====*/
+    bool to_bool(void)
     {
         assert(is_valid());
-        auto ret = import("operator")["__contains__"](tuple(ref_, o));
-        err("contains");
-        ret.ref_.name = o.name() + " in " + name();
+
+        const auto ret = PyObject_IsTrue(ref_);
+        err("to_bool");
 
         return ret;
     }
 
-    Python in(Python o)
+    Py_ssize_t to_ssize_t(void)
     {
-        return o.contains(*this);
+        assert(is_valid());
+
+        auto val = PyLong_AsSsize_t(ref_);
+        err("to_ssize_t");
+
+        return val;
     }
 
-    Python count_of(Python o)
+    std::size_t to_size_t(void)
     {
         assert(is_valid());
-        auto ret = import("operator")["__countOf__"](tuple(ref_, o));
-        err("count_of");
-        ret.ref_.name = o.name() + ".countOf(" + name() + ")";
 
-        return ret;
+        auto val = PyLong_AsSize_t(ref_);
+        err("to_size_t");
+
+        return val;
     }
 
-    Python index_of(Python o)
+    double to_double(void)
     {
         assert(is_valid());
-        auto ret = import("operator")["__indexOf__"](tuple(ref_, o));
-        err("index_of");
-        ret.ref_.name = o.name() + ".indexOf(" + name() + ")";
 
-        return ret;
+        auto val = PyFloat_AsDouble(ref_);
+        err("to_double");
+
+        return val;
     }
 
 private:
-    template <std::size_t i, typename ...Args>
-    class is_starred
+    /// Set an OverflowError and return false if \var val doesn't fit in \var T
+    template <typename T, typename V>
+    static bool check_range([[maybe_unused]] const V val)
     {
-    public:
-        using type = typename std::tuple_element<i, std::tuple<Args...>>::type;
-        static constexpr bool value = std::is_same<type, Starred<Python>>::value
-                                   || std::is_same<type, Starred<PyIndexProxy<std::string>>>::value
-                                   || std::is_same<type, Starred<PyIndexProxy<Py_ssize_t>>>::value
-                                   || std::is_same<type, Starred<PyIndexProxy<Python>>>::value;
-    };
+        // V is either long long or unsigned long long
+        if constexpr(sizeof(T) < sizeof(V))
+        {
+            const bool under = std::is_signed<V>::value && val < static_cast<V>(std::numeric_limits<T>::min());
+            if (under || val > static_cast<V>(std::numeric_limits<T>::max()))
+            {
+                PyErr_SetString(PyExc_OverflowError, "value out of range of the C++ type");
+                return false;
+            }
+        }
 
-    template <typename T, typename ...Args>
-    class starred_count
+        return true;
+    }
+
+    /// Convert the items of the list or tuple \var seq in \var out, one at a time
+    template <typename Container>
+    static bool extract_items(PyObject* seq, Container& out)
     {
-    public:
-        static constexpr std::size_t value = is_starred<0, T>::value
-                                           + starred_count<Args...>::value;
-    };
+        const auto size = PySequence_Fast_GET_SIZE(seq);
+        auto items = PySequence_Fast_ITEMS(seq);
 
+        if constexpr(is_instance<Container, std::vector>::value)
+            out.reserve(size);
 
-    template <typename T>
-    class starred_count<T>
-    {
-    public:
-        static constexpr std::size_t value = is_starred<0, T>::value;
-    };
+        for (Py_ssize_t i = 0; i < size; i++)
+        {
+            typename Container::value_type value{};
+            if (extract(items[i], value) == false)
+                return false;
 
-    static void assign_error_not_enough(const std::size_t expected, const std::size_t got)
-    {
-        std::stringstream msg;
-        msg << "not enough values to unpack (expected "
-            << expected << ", got " << got << ")";
-        PyErr_SetString(PyExc_ValueError, msg.str().c_str());
-        err("assign");
+            out.push_back(std::move(value));
+        }
+
+        return true;
     }
 
-    static void assign_error_too_many(const std::size_t expected, const std::size_t got)
+    /// Convert the items of the sequence \var seq of size \var N in the tuple-like \var out
+    template <std::size_t N, typename Tuple, std::size_t ...I>
+    static bool extract_tuple(PyObject* ptr, Tuple& out, std::index_sequence<I...>)
     {
-        std::stringstream msg;
-        msg << "too many values to unpack (expected "
-            << expected << ", got " << got << ")";
-        PyErr_SetString(PyExc_ValueError, msg.str().c_str());
-        err("assign");
+        auto seq = Python(PySequence_Fast(ptr, "expected a sequence"), "sequence");
+        if (seq.is_valid() == false)
+            return false;
+
+        if (PySequence_Fast_GET_SIZE(seq.ref_.ptr) != N)
+        {
+            PyErr_Format(PyExc_ValueError, "expected a sequence of size %zu, got %zd",
+                         N, PySequence_Fast_GET_SIZE(seq.ref_.ptr));
+            return false;
+        }
+
+        auto items = PySequence_Fast_ITEMS(seq.ref_.ptr);
+
+        return (extract(items[I], std::get<I>(out)) && ...);
     }
 
-    template <int way, std::size_t i, std::size_t tend, typename ...To>
-    static void one_way_assign(Python from, const std::size_t fend, std::tuple<To&...> to)
+    /// Convert \var ptr in \var out, return false (with the python error set) on failure
+    template <typename T>
+    static bool extract(PyObject* ptr, T& out)
     {
-        if constexpr(way > 0)
+        constexpr bool is_char = std::is_same<T, char>::value || std::is_same<T, wchar_t>::value
+                              || std::is_same<T, char16_t>::value || std::is_same<T, char32_t>::value;
+
+        if constexpr(std::is_same<T, Python>::value)
         {
-            // [0, tend] = [0, fend]
-            if constexpr(i == tend)
-                // starred part
-                std::get<i>(to) = static_cast<Python>(from.slice(Python(i)));  // i to fend
-            else
-            {
-                std::get<i>(to) = from[i];
-                one_way_assign<way, i + 1, tend>(from, tend, to);
-            }
+            out = borrow(ptr);
+            return true;
         }
-        else
+        else if constexpr(std::is_same<T, bool>::value)
         {
-            if constexpr(i == 0)
-                // starred part
-                std::get<0>(to) = static_cast<Python>(from.slice(Python(0), Python(fend + 1))); // 0 to i
-            else
+            const auto val = PyObject_IsTrue(ptr);
+            out = val;
+
+            return val != -1;
+        }
+        else if constexpr(std::is_floating_point<T>::value)
+        {
+            out = PyFloat_AsDouble(ptr);
+            return out != -1 || PyErr_Occurred() == nullptr;
+        }
+        else if constexpr(std::is_integral<T>::value && is_char == false && std::is_signed<T>::value)
+        {
+            const auto val = PyLong_AsLongLong(ptr);
+            if (val == -1 && PyErr_Occurred())
+                return false;
+
+            out = val;
+            return check_range<T>(val);
+        }
+        else if constexpr(std::is_integral<T>::value && is_char == false)
+        {
+            const auto val = PyLong_AsUnsignedLongLong(ptr);
+            if (val == static_cast<unsigned long long>(-1) && PyErr_Occurred())
+                return false;
+
+            out = val;
+            return check_range<T>(val);
+        }
+        else if constexpr(std::is_same<T, std::string>::value)
+        {
+            Py_ssize_t size;
+            auto str = PyUnicode_AsUTF8AndSize(ptr, &size);
+            if (str == nullptr)
+                return false;
+
+            out.assign(str, size);
+            return true;
+        }
+        else if constexpr(is_instance<T, std::optional>::value)
+        {
+            if (ptr == Py_None)
             {
-                std::get<i>(to) = from[fend];
-                one_way_assign<way, i - 1, tend>(from, fend - 1, to);
+                out.reset();
+                return true;
             }
+
+            return extract(ptr, out.emplace());
         }
-    }
+        else if constexpr(is_instance<T, std::pair>::value)
+            return extract_tuple<2>(ptr, out, std::make_index_sequence<2>());
+        else if constexpr(is_instance<T, std::tuple>::value || is_std_array<T>::value)
+        {
+            constexpr auto size = std::tuple_size<T>::value;
+            return extract_tuple<size>(ptr, out, std::make_index_sequence<size>());
+        }
+        else if constexpr(is_instance<T, std::vector>::value || is_instance<T, std::list>::value)
+        {
+            auto seq = Python(PySequence_Fast(ptr, "expected a sequence"), "sequence");
+            if (seq.is_valid() == false)
+                return false;
 
-    template <std::size_t b, std::size_t e, std::size_t tend, typename ...To>
-    static void two_way_assign(Python from, const std::size_t fend, [[maybe_unused]] std::tuple<To&...> to)
-    {
-        if constexpr(b < e)
+            return extract_items(seq.ref_.ptr, out);
+        }
+        else if constexpr(is_instance<T, std::map>::value || is_instance<T, std::unordered_map>::value)
         {
-            constexpr bool bs = is_starred<b, To...>::value;
-            constexpr bool es = is_starred<e, To...>::value;
+            // mappings other than dict are converted through their items
+            if (PyDict_Check(ptr) == false)
+            {
+                auto items = Python(PyMapping_Items(ptr), "items");
+                if (items.is_valid() == false)
+                    return false;
 
-            // shouldn't raise at all
-            assert((bs && es) == false && "two starred expressions in same assign");
+                std::vector<std::pair<typename T::key_type, typename T::mapped_type>> pairs;
+                if (extract_items(items.ref_.ptr, pairs) == false)
+                    return false;
+
+                out.insert(std::make_move_iterator(pairs.begin()), std::make_move_iterator(pairs.end()));
+                return true;
+            }
+
+            if constexpr(is_instance<T, std::unordered_map>::value)
+                out.reserve(PyDict_GET_SIZE(ptr));
+
+            Py_ssize_t pos = 0;
+            PyObject* key;
+            PyObject* value;
+            while (PyDict_Next(ptr, &pos, &key, &value))
+            {
+                typename T::key_type k{};
+                typename T::mapped_type v{};
+                if (extract(key, k) == false || extract(value, v) == false)
+                    return false;
 
-            if (bs == false)
-                std::get<b>(to) = from[b];
-            if (es == false)
-                std::get<e>(to) = from[fend];
+                out.emplace(std::move(k), std::move(v));
+            }
 
-            // b is starred (freeze b in position, while e keep going)
-            if constexpr(bs)
-                two_way_assign<b, e - 1, tend>(from, fend - 1, to);
-            // e is starred (freeze e in position, while b keep going)
-            else if constexpr(es)
-                two_way_assign<b + 1, e, tend>(from, fend, to);
-            // no starred (yet) - b and e keep going
-            else
-                two_way_assign<b + 1, e - 1, tend>(from, fend - 1, to);
+            return true;
         }
-        // slice or odd size
-        if constexpr(b == e)
+        else
         {
-            // starred expression
-            if constexpr(is_starred<b, To...>::value)
-                std::get<b>(to) = from.slice(Python(b), Python(fend + 1));
-            // odd size without starred
-            else if (e == fend)
-                std::get<b>(to) = from[b];
-            else
-                assign_error_not_enough(tend + 1, tend + fend - e + 1);
+            static_assert(is_char == false && is_iterable<T>::value == false,
+                          "unsupported type for as<T>()");
+            PyErr_SetString(PyExc_TypeError, "unsupported C++ type");
+            return false;
         }
-        // even size without slice (fend > e means unequal size for assign)
-        else if (b > e && fend > e)
-            assign_error_too_many(tend + 1, tend + fend - e + 1);
     }
 
 public:
-    template <typename ...To>
-    static void assign(Python from, To&&... to)
+    /// Convert the object (and its items for containers) to the C++ type \var T
+    /// Support numbers, bool, std::string, Python, and std::vector, std::list, std::array,
+    /// std::map, std::unordered_map, std::pair, std::tuple and std::optional of those
+    template <typename T>
+    T as(void)
     {
-        // ensures there is less than 2 starred expressions
-        static_assert(starred_count<To...>::value < 2);
-
-        assert(PyTuple_Check(from) || PyList_Check(from) || PyDict_Check(from));
+        // a failed call, with muted errors (see try_), the error being still pending
+        if (is_valid() == false && mute_error && PyErr_Occurred())
+            return T{};
 
-        // handle dict's case (return keys)
-        from = static_cast<PyObject*>(Starred(from));
+        assert(is_valid());
 
-        /// Index of last element of to
-        constexpr std::size_t tend = sizeof...(To) - 1;
-        /// Index of last element of from
-        const std::size_t fend = from.size() - 1;
+        T ret{};
+        extract(ref_.ptr, ret);
+        err("as");
 
-        // starred at begin (*a, b, c)
-        if constexpr(is_starred<0, To...>::value)
-            one_way_assign<-1, tend, tend>(from, fend, std::forward_as_tuple(to...));
-        // starred at end (a, b, *c)
-        else if constexpr(is_starred<tend, To...>::value)
-            one_way_assign<1, 0, tend>(from, fend, std::forward_as_tuple(to...));
-        // starred in-between or none (a, b, c or a, *b, c)
-        else
-            two_way_assign<0, tend, tend>(from, fend, std::forward_as_tuple(to...));
+        return ret;
     }
 
-    bool is_valid(void) const
+    /// Same as as, giving std::nullopt if the object can't be converted to \var T
+    /// (no exception is created, the error is discarded)
+    template <typename T>
+    std::optional<T> try_as(void)
     {
-        return ref_;
-    }
+        assert(is_valid());
 
-    std::string name(void) const
-    {
-        return ref_.name;
+        T ret{};
+        if (extract(ref_.ptr, ret) == false || PyErr_Occurred())
+        {
+            PyErr_Clear();
+            return std::nullopt;
+        }
+
+        return ret;
     }
 
-    Type get_type(void)
+    /// UTF-8 content of the str, without copy (valid as long as the object is alive)
+    std::string_view as_utf8_view(void) const
     {
         assert(is_valid());
 
-        if (PyDict_Check(ref_))
-            return Type::Dict;
-        else if (PySequence_Check(ref_))
-            return Type::Sequence;
-        else
-            return Type::Object;
+        Py_ssize_t size = 0;
+        auto str = PyUnicode_AsUTF8AndSize(ref_, &size);
+        err("as_utf8_view");
+
+        return str ? std::string_view(str, size) : std::string_view();
     }
 
-    /*=====  DICT  =====*/
-    /// Return a slice of a Sequence
-    auto slice(Python start = None, Python stop = None, Python step = None)
+    /// Code points of the str (same as utf32)
+    utf32_t ucs4(void) const
     {
-        std::string name = this->name() + "["
-                         + (start == None ? "" : start.name()) + ":"
-                         + (stop == None ? "" : stop.name()) + ":"
-                         + (step == None ? "" : step.name()) + "]";
-        Python slice_obj = Python(PySlice_New(start, stop, step), name);
+        return code_points<utf32_t::value_type>();
+    }
 
-        return (*this)[slice_obj];
+    /*===== String convertions =====*/
+    utf32_t utf32(void) const
+    {
+        return code_points<utf32_t::value_type>();
     }
 
-    /// Return an iterator on the iterable
-    auto iter(void)
+    /// UTF-16 content of the str (code points above U+FFFF become surrogate pairs)
+    utf16_t utf16(void) const
     {
         assert(is_valid());
+        if (check_str("utf16") == false)
+            return utf16_t();
 
-        auto ptr = PyObject_GetIter(ref_.ptr);
-        err("iter");
+        const auto kind = PyUnicode_KIND(ref_.ptr);
+        const auto data = PyUnicode_DATA(ref_.ptr);
+        const auto length = PyUnicode_GET_LENGTH(ref_.ptr);
+
+        // only strings with 4 bytes characters can be outside of the BMP
+        Py_ssize_t size = length;
+        if (kind == PyUnicode_4BYTE_KIND)
+            for (Py_ssize_t i = 0; i < length; i++)
+                size += PyUnicode_READ(kind, data, i) > 0xFFFF;
+
+        utf16_t string(size, 0);
+        for (Py_ssize_t i = 0, j = 0; i < length; i++)
+        {
+            const Py_UCS4 c = PyUnicode_READ(kind, data, i);
+            if (c > 0xFFFF)
+            {
+                string[j++] = 0xD800 + ((c - 0x10000) >> 10);
+                string[j++] = 0xDC00 + ((c - 0x10000) & 0x3FF);
+            }
+            else
+                string[j++] = c;
+        }
 
-        return Python(ptr, name() + ".__iter__()");
+        return string;
     }
 
-    auto next(void)
+    utf8_t utf8(void) const
     {
-        assert(is_valid() && PyIter_Check(ref_.ptr));
-
-        auto ptr = PyIter_Next(ref_.ptr);
-        if (PyErr_Occurred() && PyErr_ExceptionMatches(PyExc_StopIteration))
-            throw StopIteration();
-        else
-            err("next");
+        return utf8_t(as_utf8_view());
+    }
 
-        return Python(ptr, name() + ".__next__()");
+    /// UTF-8 content of the str
+    std::string string(void) const
+    {
+        return std::string(as_utf8_view());
     }
 
-    /// Return the size of an object (must be an iterable)
-    Py_ssize_t size(void) const
+    std::wstring wstring(void) const
     {
         assert(is_valid());
 
-        auto ret = PyObject_Size(ref_.ptr);
-        err("size");
+        // size with the final null character
+        auto size = PyUnicode_AsWideChar(ref_, nullptr, 0);
+        err("wstring");
+        if (size <= 0)
+            return std::wstring();
 
-        return ret;
+        std::wstring string(size - 1, 0);
+        PyUnicode_AsWideChar(ref_, string.data(), size);
+        err("wstring");
+
+        return string;
     }
 
-    /// Return current dict's keys
-    Python keys(void)
+private:
+    /// Raise a TypeError unless the object is a str (its content is read directly)
+    bool check_str(const char* func) const
     {
-        assert(PyDict_Check(ref_.ptr))
+        if (PyUnicode_Check(ref_.ptr))
+            return true;
 
-        auto ptr = PyDict_Keys(ref_.ptr);
-        err("keys");
-
-        return Python(ptr, name() + ".keys()");
+        PyErr_Format(PyExc_TypeError, "expected a str, got %s", Py_TYPE(ref_.ptr)->tp_name);
+        err(func);
+        return false;
     }
 
-    /// Return current dict's values
-    Python values(void)
+    /// Code points of the str, as \var char_t (one allocation)
+    template <typename char_t>
+    std::basic_string<char_t> code_points(void) const
     {
-        assert(PyDict_Check(ref_.ptr))
+        assert(is_valid());
+        if (check_str("code_points") == false)
+            return std::basic_string<char_t>();
+
+        const auto kind = PyUnicode_KIND(ref_.ptr);
+        const auto data = PyUnicode_DATA(ref_.ptr);
+        const auto length = PyUnicode_GET_LENGTH(ref_.ptr);
 
-        auto ptr = PyDict_Values(ref_.ptr);
-        err("values");
+        std::basic_string<char_t> string(length, 0);
+        for (Py_ssize_t i = 0; i < length; i++)
+            string[i] = PyUnicode_READ(kind, data, i);
 
-        return Python(ptr, name() + ".values()");
+        return string;
     }
 
-    /*===== OBJECT =====*/
-    /// Return true if the object has attribute \var name
-    bool hasattr(const std::string& name)
+private:
+    /// Module imported through import, and the key used to check it in sys.modules
+    struct ModuleEntry
     {
-        assert(is_valid());
+        PyRef key;
+        PyRef module;
+        PyRef dict;
+    };
 
-        auto ret = PyObject_HasAttrString(ref_, name.c_str());
-        err("hasattr");
+    /// Objects cached by the library, which belong to a single interpreter
+    struct InterpreterCache
+    {
+        std::unordered_map<std::string, ModuleEntry> modules;
+        /// Keys interned from string literals, by address of the literal
+        std::unordered_map<const char*, PyRef> literal_keys;
+        /// Type of the objects created by export_buffer
+        PyRef buffer_type;
+        /// Type of the objects created by stream
+        PyRef stream_type;
+        /// Code objects created by compile, most recently used first
+        struct
+        {
+            std::list<std::pair<std::string, PyRef>> order;
+            std::unordered_map<std::string, std::list<std::pair<std::string, PyRef>>::iterator> index;
+        } codes;
+        # if PY_VERSION_HEX >= 0x030C0000
+        /// Watcher of the module dicts the Lookup handles depend on, added on first use
+        std::optional<int> dict_watcher;
+        /// Changes of each watched dict (see Lookup)
+        std::unordered_map<PyObject*, std::uint64_t> dict_changes;
+        # endif
+    };
 
-        return ret;
-    }
+    static inline std::atomic<bool> initialized_ = false;
+    /// Number of terminate calls, the Lookup handles of a previous interpreter drop their objects
+    static inline std::atomic<std::uint64_t> lookup_epoch_ = 0;
+    /// Thread state of the initialization, released when it was done by a GILAcquire
+    static inline PyThreadState* init_state_ = nullptr;
+    /// Number of code objects kept by compile in each interpreter
+    static inline std::atomic<std::size_t> code_cache_size_ = 128;
+    static inline std::mutex initialize_mutex_;
 
-    /// Get attribute of object (it's the only way to get attributes of iterables)
-    # define ATTR(TYPE) auto attr(TYPE key)             \
-    {                                                   \
-        assert(is_valid());                             \
-        return PyIndexProxy(ref_, Type::Object, key);   \
-    }
-    ATTR(const std::string&)
-    ATTR(Python&)
+    // the caches are only used while holding the GIL of their interpreter, which protects them
+    static inline InterpreterCache main_cache_;
+    /// Cache of the interpreter the current thread runs (changed by InterpreterPool)
+    static inline thread_local InterpreterCache* cache_ = &main_cache_;
 
-    /// Delete the attribute \var name of the current object
-    bool delattr(const std::string& name)
-    {
-        assert(is_valid());
+    // error handling is configured per thread
+    static inline thread_local bool mute_error = false;
+    static inline thread_local void (*finally_func)() = nullptr;
 
-        auto ret = PyObject_DelAttrString(ref_, name.c_str()) + 1;
-        err("delattr");
+    PyRef ref_;
 
-        return ret;
-    }
+    // typed handles (PyList, PyTuple...) use the reference and the error handling
+    template <typename Handle>
+    friend class PyTyped;
 
-    /// Print the object on the file \var fp, print the representation if \var repr is True
-    void print(const bool repr = false, FILE* fp = stdout) const
-    {
-        PyObject_Print(ref_.ptr, fp, repr ? Py_PRINT_RAW : 0);
-        fprintf(fp, "\n");
-        err("print");
-    }
+public:
+    // NOTE: these are immortal since python 3.12, so they are shared by every interpreter
+    static inline PyRef True = PyRef(Py_True, "True", PyRef::borrow);
+    static inline PyRef False = PyRef(Py_False, "False", PyRef::borrow);
+    static inline PyRef None = PyRef(Py_None, "None", PyRef::borrow);
+    static inline PyRef Ellipsis = PyRef(Py_Ellipsis, "Ellipsis", PyRef::borrow);
+};
+/// Interned key from a string literal, like obj["field"_key]
+inline Python::Key operator""_key(const char* str, std::size_t size)
+{
+    return Python::Key(str, size);
+}
 
-    /*===== FUNCTION =====*/
-    /// Call the object with \var args as arguments and \var kwargs as keywords
-    Python call(Python args = nullptr, Python kwargs = nullptr)
+/// Python object whose type was checked once, at construction (see PyList, PyTuple...)
+/// \var Handle gives the check and the name of the type
+template <typename Handle>
+class PyTyped : public Python
+{
+public:
+    /// Check the type of \var o (TypeError otherwise)
+    explicit PyTyped(Python o)
+        : Python(std::move(o))
     {
         assert(is_valid());
 
-        bool tup = args.is_valid();
+        if (Handle::check(ref_.ptr) == false)
+        {
+            PyErr_Format(PyExc_TypeError, "expected %s, got %s", Handle::type_name, Py_TYPE(ref_.ptr)->tp_name);
+            ref_ = PyRef();
+            err(Handle::type_name);
+        }
+    }
 
-        // args must be at least an empty tuple
-        // FYI, not being an iterable object raise a MemoryError
-        if (args.is_valid() == false)
-            args = tuple();
+    /// Return true if \var o can be held by the handle
+    static bool is(PyObject* o)
+    {
+        return o && Handle::check(o);
+    }
 
-        auto ret = PyObject_Call(ref_, args, kwargs);
-        err("call");
+protected:
+    using Python::ref_;
+    using Python::err;
+    using Python::to_string;
+    using Python::check_range;
+};
 
-        auto nargs = args.name();
-        if (kwargs)
-        {
-            nargs.pop_back();       // remove ending parenthesis
+/// list, indexed without any type dispatch
+class PyList : public PyTyped<PyList>
+{
+public:
+    using PyTyped::PyTyped;
 
-            if (tup)                // add "," to make distinction with args
-                nargs += ", ";
+    static constexpr const char* type_name = "list";
 
-            // add kwargs
-            const auto kwarg = kwargs.name().substr(1, kwargs.name().size() - 1);
-            nargs += kwarg + ")";// std::regex_replace(kwarg, kwargs_regex, "$1 = ") + ")";
-        }
+    static bool check(PyObject* o)
+    {
+        return PyList_Check(o);
+    }
 
-        return Python(ret, name() + nargs);
+    Py_ssize_t size(void) const
+    {
+        return PyList_GET_SIZE(ref_.ptr);
     }
 
-    /// Call the function \var name in object with \var args as arguments and \var kwargs as keywords
-    Python call(const std::string& name, Python args = nullptr, Python kwargs = nullptr)
+    // WARNING: unchecked, \var i must be in [0, size())
+    /// Item \var i (PyList_GET_ITEM)
+    Python operator[](const Py_ssize_t i) const
     {
-        assert(is_valid());
+        assert(i >= 0 && i < size());
 
-        return attr(name).call(args, kwargs);
+        return Python(PyList_GET_ITEM(ref_.ptr, i), PYNAME(name() + "[" + std::to_string(i) + "]"), PyRef::borrow);
     }
 
-    /*===== MISC =====*/
-    static void set_finally(void (*func)())
+    /// Replace the item \var i by \var value (\var i must be in [0, size()))
+    void set(const Py_ssize_t i, Python value)
     {
-        finally_func = func;
+        assert(i >= 0 && i < size() && value.is_valid());
+
+        // the new item is stolen, the old one released
+        PyList_SetItem(ref_.ptr, i, value.release());
+        err("PyList::set");
     }
 
-    /*===== CONVERSIONS =====*/
-    bool to_bool(void)
+    /// Append \var value at the end of the list
+    void append(Python value)
     {
-        assert(is_valid());
+        assert(value.is_valid());
 
-        const auto ret = PyObject_IsTrue(ref_);
-        err("to_bool");
-
-        return ret;
+        PyList_Append(ref_.ptr, value);
+        err("PyList::append");
     }
+};
 
-    Py_ssize_t to_ssize_t(void)
-    {
-        assert(is_valid());
+/// tuple, indexed without any type dispatch
+class PyTuple : public PyTyped<PyTuple>
+{
+public:
+    using PyTyped::PyTyped;
 
-        auto val = PyLong_AsSsize_t(ref_);
-        err("to_ssize_t");
+    static constexpr const char* type_name = "tuple";
 
-        return val;
+    static bool check(PyObject* o)
+    {
+        return PyTuple_Check(o);
     }
 
-    std::size_t to_size_t(void)
+    Py_ssize_t size(void) const
     {
-        assert(is_valid());
+        return PyTuple_GET_SIZE(ref_.ptr);
+    }
 
-        auto val = PyLong_AsSize_t(ref_);
-        err("to_size_t");
+    // WARNING: unchecked, \var i must be in [0, size())
+    /// Item \var i (PyTuple_GET_ITEM)
+    Python operator[](const Py_ssize_t i) const
+    {
+        assert(i >= 0 && i < size());
 
-        return val;
+        return Python(PyTuple_GET_ITEM(ref_.ptr, i), PYNAME(name() + "[" + std::to_string(i) + "]"), PyRef::borrow);
     }
+};
 
-    double to_double(void)
-    {
-        assert(is_valid());
+/// dict, accessed with PyDict_* functions only (keys are Key or Python)
+class PyDict : public PyTyped<PyDict>
+{
+    template <typename K>
+    static constexpr bool is_key = std::is_same<K, Python::Key>::value || std::is_base_of<Python, K>::value;
 
-        auto val = PyFloat_AsDouble(ref_);
-        err("to_double");
+public:
+    using PyTyped::PyTyped;
 
-        return val;
+    static constexpr const char* type_name = "dict";
+
+    static bool check(PyObject* o)
+    {
+        return PyDict_Check(o);
     }
 
-    Py_UCS4* ucs4(void)
+    Py_ssize_t size(void) const
     {
-        assert(is_valid());
+        return PyDict_GET_SIZE(ref_.ptr);
+    }
 
-        constexpr int len = 200;
+    /// Value of \var key (KeyError if missing)
+    template <typename K>
+    Python operator[](K key) const
+    {
+        static_assert(is_key<K>, "dict keys must be Key or Python");
 
-        Py_UCS4 buffer[len];
-        auto ret = PyUnicode_AsUCS4(ref_, buffer, len, true);
-        err("UCS4");
+        auto value = PyDict_GetItemWithError(ref_.ptr, key);
+        if (value == nullptr && PyErr_Occurred() == nullptr)
+        {
+            // wrapped in a tuple so that tuple keys are not unpacked
+            auto args = PyTuple_Pack(1, static_cast<PyObject*>(key));
+            PyErr_SetObject(PyExc_KeyError, args);
+            Py_XDECREF(args);
+        }
+        err("PyDict[]");
 
-        return ret;
+        return Python(value, PYNAME(name() + "[" + to_string(key) + "]"), PyRef::borrow);
     }
 
-    /*===== Narrowing string convertions =====*/
-    // for non-narrowing, use the converter
-    utf32_t utf32(void)
+    /// Value of \var key, or \var fallback if missing
+    template <typename K>
+    Python get(K key, Python fallback = None) const
     {
-        utf32_t string;
+        static_assert(is_key<K>, "dict keys must be Key or Python");
 
-        for (auto c = ucs4(); *c; c++)
-            string.push_back(*c & std::numeric_limits<utf32_t::value_type>::max());
+        auto value = PyDict_GetItemWithError(ref_.ptr, key);
+        err("PyDict::get");
 
-        return string;
+        if (value == nullptr)
+            return fallback;
+
+        return Python(value, PYNAME(name() + "[" + to_string(key) + "]"), PyRef::borrow);
     }
 
-    utf16_t utf16(void)
+    /// Return true if the dict has the key \var key
+    template <typename K>
+    bool contains(K key) const
     {
-        utf16_t string;
+        static_assert(is_key<K>, "dict keys must be Key or Python");
 
-        for (auto c = ucs4(); *c; c++)
-            string.push_back(*c & std::numeric_limits<utf16_t::value_type>::max());
+        auto ret = PyDict_Contains(ref_.ptr, key);
+        err("PyDict::contains");
 
-        return string;
+        return ret == 1;
     }
 
-    utf8_t utf8(void)
+    /// Set the value of \var key to \var value
+    template <typename K>
+    void set(K key, Python value)
     {
-        utf8_t string;
+        static_assert(is_key<K>, "dict keys must be Key or Python");
+        assert(value.is_valid());
 
-        for (auto c = ucs4(); *c; c++)
-            string.push_back(*c & std::numeric_limits<utf8_t::value_type>::max());
+        PyDict_SetItem(ref_.ptr, key, value);
+        err("PyDict::set");
+    }
+};
 
-        return string;
+/// str, indexed by code point without creating any object
+class PyStr : public PyTyped<PyStr>
+{
+public:
+    using PyTyped::PyTyped;
+
+    static constexpr const char* type_name = "str";
+
+    static bool check(PyObject* o)
+    {
+        return PyUnicode_Check(o);
     }
 
-    std::string string(void)
+    /// Number of code points
+    Py_ssize_t size(void) const
     {
-        std::string string;
+        return PyUnicode_GET_LENGTH(ref_.ptr);
+    }
 
-        for (auto c = ucs4(); *c; c++)
-            string.push_back(*c & std::numeric_limits<std::string::value_type>::max());
+    // WARNING: unchecked, \var i must be in [0, size())
+    /// Code point \var i (PyUnicode_READ_CHAR)
+    char32_t operator[](const Py_ssize_t i) const
+    {
+        assert(i >= 0 && i < size());
 
-        return string;
+        return PyUnicode_READ_CHAR(ref_.ptr, i);
     }
+};
 
-    std::wstring wstring(void)
-    {
-        std::wstring string;
+/// int, converted without going through the generic convertion
+class PyInt : public PyTyped<PyInt>
+{
+public:
+    using PyTyped::PyTyped;
 
-        for (auto c = ucs4(); *c; c++)
-            string.push_back(*c & std::numeric_limits<std::wstring::value_type>::max());
+    static constexpr const char* type_name = "int";
 
-        return string;
+    static bool check(PyObject* o)
+    {
+        return PyLong_Check(o);
     }
 
-private:
-    static inline bool initialized_ = false;
-    static inline bool mute_error = false;
-    static inline void (*finally_func)() = nullptr;
+    /// Value of the int as \var T (OverflowError if it doesn't fit)
+    template <typename T = long long>
+    T value(void) const
+    {
+        static_assert(std::is_integral<T>::value, "PyInt can only be converted to integers");
 
-    PyRef ref_;
+        if constexpr(std::is_signed<T>::value)
+        {
+            const auto val = PyLong_AsLongLong(ref_.ptr);
+            if ((val != -1 || PyErr_Occurred() == nullptr) && check_range<T>(val))
+                return val;
+        }
+        else
+        {
+            const auto val = PyLong_AsUnsignedLongLong(ref_.ptr);
+            if ((val != static_cast<unsigned long long>(-1) || PyErr_Occurred() == nullptr) && check_range<T>(val))
+                return val;
+        }
 
-public:
-    static inline PyRef True = PyRef(Py_True, "True", true);
-    static inline PyRef False = PyRef(Py_False, "False", true);
-    static inline PyRef None = PyRef(Py_None, "None", true);
-    static inline PyRef Ellipsis = PyRef(Py_Ellipsis, "Ellipsis", true);
-};
\ No newline at end of file
+        err("PyInt::value");
+        return T();
+    }
+};
@@ -0,0 +1,110 @@
+// TEST: export_buffer (zero-copy export of C++ containers), buffer (zero-copy views)
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    auto memoryview = Python::builtins()["memoryview"_key];
+
+    // writable export, python writes directly in the vector
+    std::vector<double> v = {1.5, 2.5, 3.5};
+    {
+        auto view = Python(memoryview(Python::export_buffer(v)));
+        std::cout << "d => ";
+        view.attr("format").print();
+
+        std::cout << "[1.5, 2.5, 3.5] => ";
+        view.method("tolist"_key).print();
+
+        view[1] = 42.0;
+        view.method("release"_key);
+    }
+    assert(v[1] == 42.0);
+
+    // read-only export
+    const std::array<int, 4> a = {1, 2, 3, 4};
+    auto ro = Python(memoryview(Python::export_buffer(a)));
+    assert(Python(ro.attr("readonly")).to_bool());
+    std::cout << "[1, 2, 3, 4] => ";
+    ro.method("tolist"_key).print();
+
+    // multi-dimensional export
+    std::vector<int> m = {1, 2, 3, 4, 5, 6};
+    auto matrix = Python(memoryview(Python::export_buffer(m.data(), {2, 3})));
+    std::cout << "(2, 3) => ";
+    matrix.attr("shape").print();
+    std::cout << "(12, 4) => ";
+    matrix.attr("strides").print();
+    std::cout << "[[1, 2, 3], [4, 5, 6]] => ";
+    matrix.method("tolist"_key).print();
+
+    // the format is only given when requested, and required to see the shape of other items than bytes
+    auto exported = Python::export_buffer(m.data(), {2, 3});
+    Py_buffer raw;
+    [[maybe_unused]] int ret = PyObject_GetBuffer(exported, &raw, PyBUF_ND | PyBUF_FORMAT);
+    assert(ret == 0 && std::string(raw.format) == "i" && raw.itemsize == 4 && raw.ndim == 2);
+    PyBuffer_Release(&raw);
+
+    ret = PyObject_GetBuffer(exported, &raw, PyBUF_SIMPLE);
+    assert(ret == 0 && raw.format == nullptr && raw.itemsize == 1 && raw.len == 24);
+    PyBuffer_Release(&raw);
+
+    ret = PyObject_GetBuffer(exported, &raw, PyBUF_ND);
+    assert(ret == -1 && PyErr_ExceptionMatches(PyExc_BufferError));
+    PyErr_Clear();
+
+    std::vector<std::uint8_t> octets = {1, 2};
+    ret = PyObject_GetBuffer(Python::export_buffer(octets), &raw, PyBUF_ND);
+    assert(ret == 0 && raw.format == nullptr && raw.itemsize == 1 && raw.shape[0] == 2);
+    PyBuffer_Release(&raw);
+
+    // the moved vector lives as long as the python object
+    auto owned = Python::export_buffer(std::vector<float>{0.5f, 0.25f});
+    std::cout << "[0.5, 0.25] => ";
+    Python(memoryview(owned)).method("tolist"_key).print();
+
+    auto array = Python::import("array")["array"_key]("f");
+    array.method("frombytes"_key, owned);
+    std::cout << "array('f', [0.5, 0.25]) => ";
+    array.print();
+
+    // read-only view on bytes
+    auto bytes = Python::builtins()["bytes"_key](Python::list(1, 2, 3));
+    auto bytes_view = bytes.buffer<const std::uint8_t>();
+    assert(bytes_view.size() == 3 && bytes_view[2] == 3);
+
+    // writable view on an array, C++ writes directly in the python object
+    auto floats = Python::import("array")["array"_key]("d", Python::list(1.0, 2.0, 3.0));
+    {
+        auto floats_view = floats.buffer<double>();
+        for (auto& f : floats_view)
+            f *= 2;
+    }
+    std::cout << "array('d', [2.0, 4.0, 6.0]) => ";
+    floats.print();
+
+    // multi-dimensional view
+    auto matrix_view = matrix.buffer<const int>();
+    assert(matrix_view.ndim() == 2 && matrix_view.shape(1) == 3);
+    assert(matrix_view(0, 2) == 3 && matrix_view(1, 0) == 4);
+
+    // strided view (every other item)
+    auto slice = Python::builtins()["slice"_key];
+    auto odds = Python(ro[slice(Python::None, Python::None, 2)]);
+    auto odds_view = odds.buffer<const int>();
+    assert(odds_view.size() == 2 && odds_view.contiguous() == false);
+    assert(odds_view[0] == 1 && odds_view[1] == 3);
+
+    // bad format, and writable view on read-only data
+    Python::mute_errors(true);
+    floats.buffer<const int>();
+    assert(PyErr_ExceptionMatches(PyExc_TypeError));
+    PyErr_Clear();
+
+    bytes.buffer<std::uint8_t>();
+    assert(PyErr_ExceptionMatches(PyExc_BufferError));
+    PyErr_Clear();
+    Python::mute_errors(false);
+}
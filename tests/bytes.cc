@@ -0,0 +1,53 @@
+// TEST: bytes, bytearray, memoryview
+
+# include <cassert>
+# include <cstring>
+
+# include "python.hh"
+
+int main()
+{
+    std::cout << "b'abc' => ";
+    Python::bytes(std::string_view("abc")).print();
+
+    // byte containers are copied at once, not boxed one int at a time
+    const std::vector<std::byte> payload = { std::byte{0x00}, std::byte{0xff}, std::byte{0x10} };
+    std::cout << "b'\\x00\\xff\\x10' => ";
+    Python::bytes(payload).print();
+
+    std::vector<uint8_t> raw(100000, 7);
+    assert(Python::bytes(raw).size() == 100000);
+
+    // filled in place
+    auto filled = Python::bytes(4, [](char* data, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; i++)
+            data[i] = 'a' + i;
+    });
+    std::cout << "b'abcd' => ";
+    filled.print();
+
+    std::cout << "bytearray(b'xyz') => ";
+    Python::bytearray(std::string("xyz")).print();
+
+    // memoryviews share the memory of the C++ container
+    std::string shared = "hello";
+    auto view = Python::memoryview(shared);
+    view[0] = Python(static_cast<long>('j'));
+    assert(shared == "jello");
+
+    const std::string constant = "const";
+    auto readonly = Python::memoryview(constant);
+    assert(Python(readonly.attr("readonly")).to_bool());
+
+    std::cout << "b'jello' => ";
+    Python::builtins()["bytes"_key](view).print();
+
+    // memoryview of a python object
+    std::cout << "3 => ";
+    Python(static_cast<long>(Python::memoryview(Python::bytes(std::string_view("abc"))).size())).print();
+
+    // bytes are readable through the buffer protocol
+    auto buffer = filled.buffer<const char>();
+    assert(std::memcmp(buffer.data(), "abcd", 4) == 0);
+}
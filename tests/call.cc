@@ -0,0 +1,67 @@
+// TEST: call (positional, method, args/kwargs)
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    auto builtins = Python::builtins();
+
+    // positional call
+    std::cout << "42 => ";
+    builtins["max"](12, 42, Python(7)).print();
+
+    std::cout << "0 => ";
+    builtins["int"]().print();
+
+    // method call
+    auto list = Python::list(1, 2);
+    list.method("append"_key, 3);
+    list.method("extend", Python::list(4, 5));
+    std::cout << "[1, 2, 3, 4, 5] => ";
+    list.print();
+
+    std::cout << "\"a-b-c\" => ";
+    Python("-").method("join", Python::list("a", "b", "c")).print();
+
+    // tuple/dict call
+    std::cout << "[3, 2, 1] => ";
+    builtins["sorted"].call(Python::tuple(std::tuple(Python::list(2, 3, 1))), Python::dict("reverse", true)).print();
+
+    std::cout << "{} => ";
+    builtins["dict"].call().print();
+
+    std::cout << "{'a': 1} => ";
+    builtins["dict"].call(nullptr, Python::dict("a", 1)).print();
+
+    // a tuple is a single argument, call_with unpacks it
+    auto pair = Python::tuple(1, 2);
+    std::cout << "'(1, 2)' => ";
+    builtins["repr"](pair).print();
+    std::cout << "2 => ";
+    builtins["max"].call_with(pair).print();
+
+    // NULL arguments are refused before the call
+    [[maybe_unused]] bool raised = false;
+    try
+    {
+        builtins["max"](nullptr, 1);
+    }
+    catch (Python::TypeError&)
+    {
+        raised = true;
+    }
+    assert(raised);
+
+    raised = false;
+    try
+    {
+        builtins["max"].call_with(Python::list(1, 2));
+    }
+    catch (Python::TypeError&)
+    {
+        raised = true;
+    }
+    assert(raised);
+}
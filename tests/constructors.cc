@@ -1,3 +1,7 @@
+# include <cassert>
+# include <climits>
+# include <forward_list>
+
 # include "python.hh"
 
 int main()
@@ -23,6 +27,14 @@ int main()
     std::cout << "/perfectly/valid/path_or_not => ";
     Python(std::filesystem::path("/perfectly/valid/path_or_not")).print();
 
+    // non-ASCII paths are decoded like os.fsdecode, not taken byte by byte
+    const std::string raw = "/tmp/h\xc3\xa9llo/\xe2\x82\xac";
+    auto path = Python(std::filesystem::path(raw));
+    Python encoded = Python::import("os")["fsencode"_key](path);
+    assert(PyBytes_AsString(encoded) == raw);
+    if (Python::import("sys")["getfilesystemencoding"_key]().string() == "utf-8")
+        assert(path.ucs4() == U"/tmp/h\u00e9llo/\u20ac");
+
     std::cout << "0.001 => ";
     Python(0.001f).print();
 
@@ -66,6 +78,22 @@ int main()
     std::cout << "[1, 9, 7, 2, 4, 0, 0, 0, 0] => ";
     Python(b).print();
 
+    std::list<std::string> b2 = {"a", "b", "c"};
+    std::cout << "[\"a\", \"b\", \"c\"] => ";
+    Python(b2).print();
+
+    std::vector<unsigned long long> b3 = {0, 18446744073709551615ull};
+    std::cout << "(0, 18446744073709551615) => ";
+    Python::tuple(b3).print();
+
+    // scalars aren't truncated (with or without debug names)
+    std::cout << "18446744073709551615 => ";
+    Python(ULLONG_MAX).print();
+    assert(Python(ULLONG_MAX).as<unsigned long long>() == ULLONG_MAX);
+    assert(Python(LLONG_MIN).as<long long>() == LLONG_MIN);
+    assert(Python(UINT_MAX).as<unsigned>() == UINT_MAX);
+    assert(Python(ULONG_MAX).as<unsigned long>() == ULONG_MAX);
+
     std::map<std::string, unsigned> c = {{"key1", 1},
                                          {"key2", 2},
                                          {"key3", 3},
@@ -137,4 +165,21 @@ int main()
 
     std::cout << "[1, 2, 1, 2, 3, 4, \"thing\", *star1, 5.5] => ";
     Python::list(1, 2, Python::Starred(Python::list(1, 2, 3, 4)), "thing", Python::Starred(star1), 5.5).print();
-}
\ No newline at end of file
+
+    // iterables without size
+    const std::forward_list<int> forward = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    std::cout << "[1, 2, 3, 4, 5, 6, 7, 8, 9, 10] => ";
+    Python::list(forward).print();
+    std::cout << "(1, 2, 3, 4, 5, 6, 7, 8, 9, 10) => ";
+    Python::tuple(forward).print();
+    assert(PyTuple_GET_SIZE(static_cast<PyObject*>(Python::tuple(std::forward_list<int>{ 1 }))) == 1);
+
+    // an item that can't be converted gives no half-filled sequence, even with muted errors
+    Python::mute_errors(true);
+    const std::vector<std::string> invalid = { "a", "\xff" };
+    assert(Python::list(invalid).is_valid() == false && PyErr_ExceptionMatches(PyExc_UnicodeDecodeError));
+    PyErr_Clear();
+    assert(Python::tuple(invalid).is_valid() == false && PyErr_ExceptionMatches(PyExc_UnicodeDecodeError));
+    PyErr_Clear();
+    Python::mute_errors(false);
+}
@@ -0,0 +1,61 @@
+// TEST: as (scalars, containers, nested containers)
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    assert(Python(42).as<int>() == 42);
+    assert(Python(2.5).as<double>() == 2.5);
+    assert(Python(true).as<bool>());
+    assert(Python("thing").as<std::string>() == "thing");
+
+    auto v = Python::list(1.5, 2.5, 3.5).as<std::vector<double>>();
+    assert((v == std::vector<double>{1.5, 2.5, 3.5}));
+
+    auto l = Python::tuple(1, 2, 3).as<std::list<long>>();
+    assert((l == std::list<long>{1, 2, 3}));
+
+    [[maybe_unused]] auto a = Python::list(1, 2, 3).as<std::array<unsigned, 3>>();
+    assert((a == std::array<unsigned, 3>{1, 2, 3}));
+
+    auto m = Python::dict("a", 1, "b", 2).as<std::map<std::string, int>>();
+    assert((m == std::map<std::string, int>{{"a", 1}, {"b", 2}}));
+
+    auto u = Python::dict("a", 1, "b", 2).as<std::unordered_map<std::string, int>>();
+    assert(u.size() == 2 && u["b"] == 2);
+
+    auto p = Python::tuple("a", 1).as<std::pair<std::string, int>>();
+    assert(p.first == "a" && p.second == 1);
+
+    auto t = Python::tuple("a", 1, 0.5).as<std::tuple<std::string, int, float>>();
+    assert(t == std::make_tuple(std::string("a"), 1, 0.5f));
+
+    std::vector<std::optional<int>> opt = { 1, {}, 3 };
+    assert(Python(opt).as<std::vector<std::optional<int>>>() == opt);
+
+    std::vector<std::vector<std::pair<std::string, std::size_t>>> nested =
+    {
+        { { "aa", 11 }, { "ba", 21 } },
+        { { "ab", 12 } },
+        { },
+    };
+    assert(Python(nested).as<decltype(nested)>() == nested);
+
+    // errors are raised once, after the conversion
+    Python::mute_errors(true);
+    Python::list(1, "two", 3).as<std::vector<int>>();
+    assert(PyErr_ExceptionMatches(PyExc_TypeError));
+    PyErr_Clear();
+
+    Python(300).as<std::int8_t>();
+    assert(PyErr_ExceptionMatches(PyExc_OverflowError));
+    PyErr_Clear();
+    Python::mute_errors(false);
+
+    std::cout << "[1.5, 2.5, 3.5] => [";
+    for (auto d : v)
+        std::cout << d << (d == v.back() ? "" : ", ");
+    std::cout << "]" << std::endl;
+}
@@ -0,0 +1,122 @@
+// TEST: PythonError (typed catch, lazy message, restore, outside the GIL), try_, catch_as, get, get_attr, try_as
+
+# include <cassert>
+# include <cstring>
+# include <thread>
+
+# include "python.hh"
+
+int main()
+{
+    auto dict = Python::dict("a", 1);
+
+    // typed errors, nothing printed
+    [[maybe_unused]] bool raised = false;
+    try
+    {
+        auto value = Python(dict["missing"]);
+    }
+    catch (Python::KeyError& e)
+    {
+        raised = true;
+        assert(e.matches(PyExc_LookupError));
+        assert(PyErr_Occurred() == nullptr);
+
+        std::cout << "\"'missing'\" => ";
+        Python(e.value().method("__str__"_key)).print();
+    }
+    assert(raised);
+
+    // any error is a PythonError, formatted on demand
+    raised = false;
+    try
+    {
+        Python::import("this_module_does_not_exist");
+    }
+    catch (Python::PythonError& e)
+    {
+        raised = true;
+        assert(e.matches(PyExc_ModuleNotFoundError));
+        assert(std::strstr(e.what(), "ModuleNotFoundError") != nullptr);
+
+        // detached errors keep their message
+        e.detach();
+        assert(std::strstr(e.what(), "this_module_does_not_exist") != nullptr);
+    }
+    assert(raised);
+
+    // errors can go back to python
+    try
+    {
+        auto index = dict.method("index"_key);
+    }
+    catch (Python::AttributeError& e)
+    {
+        e.restore();
+    }
+    assert(PyErr_ExceptionMatches(PyExc_AttributeError));
+    PyErr_Clear();
+
+    // try_ gives an optional instead
+    [[maybe_unused]] auto found = Python::try_([&]() { return Python(dict["a"]).as<int>(); });
+    [[maybe_unused]] auto missing = Python::try_([&]() { return Python(dict["b"]).as<int>(); });
+    assert(found == 1 && missing.has_value() == false);
+
+    // misses without any exception
+    assert(dict.get("a"_key)->as<int>() == 1 && dict.get("b"_key) == std::nullopt);
+    assert(Python::list(1, 2).get(Python(5)) == std::nullopt);
+    assert(dict.get_attr("keys"_key).has_value() && dict.get_attr("index"_key) == std::nullopt);
+    assert(Python("12").try_as<int>() == std::nullopt && Python(12).try_as<int>() == 12);
+    assert(PyErr_Occurred() == nullptr);
+
+    // optionals are given as is
+    std::optional<Python> item = Python::try_([&]() { return dict.get("b"_key); });
+    assert(item == std::nullopt);
+
+    assert(Python::try_([]() { Python::import("this_module_does_not_exist"); }) == false);
+    assert(Python::try_([]() { Python::import("os"); }));
+    assert(PyErr_Occurred() == nullptr);
+
+    // the error is only built when asked for
+    std::optional<Python::PythonError> error;
+    assert(Python::try_([]() { Python::import("this_module_does_not_exist"); }, &error) == false);
+    assert(error && error->matches(PyExc_ModuleNotFoundError) && PyErr_Occurred() == nullptr);
+
+    // catch_as only discards the errors of a given type (or its subclasses)
+    [[maybe_unused]] auto caught = Python::catch_as<Python::KeyError>([&]() { return Python(dict["b"]).as<int>(); });
+    assert(caught == std::nullopt);
+    assert(Python::catch_as(PyExc_LookupError, [&]() { return Python(dict["b"]); }) == std::nullopt);
+
+    raised = false;
+    try
+    {
+        Python::catch_as<Python::KeyError>([]() { Python::import("this_module_does_not_exist"); });
+    }
+    catch (Python::ImportError&)
+    {
+        raised = true;
+    }
+    assert(raised && PyErr_Occurred() == nullptr);
+
+    // errors raised in a GIL scope are handled (copied, formatted, released) after it
+    std::string message;
+    {
+        Python::GILRelease release;
+
+        std::thread thread([&]()
+        {
+            try
+            {
+                Python::GILAcquire gil;
+                Python::import("this_module_does_not_exist");
+            }
+            catch (Python::PythonError& e)
+            {
+                auto copy = e;
+                message = copy.what();
+            }
+        });
+        thread.join();
+    }
+    assert(message.find("this_module_does_not_exist") != std::string::npos);
+}
@@ -0,0 +1,50 @@
+// TEST: compile (cache), eval, Context
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    // same source and mode, same code object
+    auto code = Python::compile("x * 2");
+    assert(static_cast<PyObject*>(code) == static_cast<PyObject*>(Python::compile("x * 2")));
+    assert(static_cast<PyObject*>(code) != static_cast<PyObject*>(Python::compile("x * 2", Py_single_input)));
+
+    auto globals = Python::dict();
+    std::cout << "42 => ";
+    Python::eval(code, globals, Python::dict("x", 21)).print();
+
+    // the old interface goes through the cache
+    std::cout << "3 => ";
+    Python::eval("1 + 2", Py_eval_input, globals, globals).print();
+
+    // least recently used code objects are dropped
+    Python::set_code_cache_size(1);
+    Python::compile("1");
+    assert(static_cast<PyObject*>(code) != static_cast<PyObject*>(Python::compile("x * 2")));
+    Python::set_code_cache_size(128);
+
+    // prepared globals, different locals
+    Python::Context context;
+    context.exec("import math\ndef area(r):\n    return math.pi * r ** 2");
+
+    double sum = 0;
+    for (int r = 0; r < 1000; r++)
+        sum += context.eval("area(r)", Python::dict("r", r)).as<double>();
+    assert(sum > 0);
+
+    std::cout << "3.141592653589793 => ";
+    context.eval("area(1)").print();
+
+    [[maybe_unused]] bool raised = false;
+    try
+    {
+        context.eval("undefined_name");
+    }
+    catch (Python::PythonError& e)
+    {
+        raised = e.matches(PyExc_NameError);
+    }
+    assert(raised);
+}
@@ -0,0 +1,25 @@
+// TEST: import (cache), from_import
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    // cached import gives back the same module dict
+    auto os1 = Python::import("os");
+    auto os2 = Python::import("os");
+    assert(static_cast<PyObject*>(os1) == static_cast<PyObject*>(os2));
+
+    // removing the module from sys.modules invalidates the cache
+    auto sys = Python::import("sys");
+    Python(sys["modules"]).call("pop", Python::tuple(std::tuple("os")));
+    auto os3 = Python::import("os");
+    assert(static_cast<PyObject*>(os1) != static_cast<PyObject*>(os3));
+
+    auto [sep, getcwd] = Python::from_import("os", "sep", "getcwd");
+    std::cout << "/ => ";
+    sep.print();
+
+    assert(getcwd().is_valid());
+}
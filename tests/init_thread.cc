@@ -0,0 +1,33 @@
+// TEST: initialization by a worker thread (GILAcquire), terminate
+
+# include <cassert>
+# include <thread>
+
+# include "python.hh"
+
+int main()
+{
+    // no use of python in the main thread before the workers
+    std::atomic<long> total = 0;
+
+    std::vector<std::thread> workers;
+    for (int id = 0; id < 2; id++)
+        workers.emplace_back([id, &total]()
+        {
+            Python::GILAcquire gil;
+            total += Python::builtins()["sum"_key](Python::list(id, 10)).as<long>();
+        });
+
+    for (auto& worker : workers)
+        worker.join();
+    assert(total == 21);
+
+    {
+        Python::GILAcquire gil;
+
+        std::cout << "3 => ";
+        Python::builtins()["len"_key](Python::list(1, 2, 3)).print();
+    }
+
+    Python::terminate();
+}
@@ -0,0 +1,74 @@
+// TEST: InterpreterPool (python 3.12+)
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    # if PY_VERSION_HEX >= 0x030C0000
+        std::vector<std::future<long>> sums;
+        std::vector<std::future<long>> ids;
+        {
+            // the interpreters may need the main GIL
+            Python::GILRelease release;
+
+            Python::InterpreterPool pool(4);
+            assert(pool.size() == 4);
+
+            for (long i = 0; i < 16; i++)
+                sums.push_back(pool.submit([i]()
+                {
+                    auto range = Python::builtins()["range"_key](i * 100000);
+                    return Python::builtins()["sum"_key](range).as<long>();
+                }));
+
+            // each interpreter has its own modules
+            for (std::size_t i = 0; i < pool.size(); i++)
+                ids.push_back(pool.submit([]()
+                {
+                    auto sys = Python::import("sys");
+                    return Python::builtins()["id"_key](sys["modules"_key]).as<long>();
+                }));
+
+            // errors are reported through the future
+            auto failed = pool.submit([]() { Python::import("this_module_does_not_exist"); });
+            bool raised = false;
+            try
+            {
+                failed.get();
+            }
+            catch (Python::PythonError&)
+            {
+                raised = true;
+            }
+            assert(raised);
+        }
+
+        for (long i = 0; i < 16; i++)
+        {
+            const long n = i * 100000;
+            assert(sums[i].get() == n * (n - 1) / 2);
+        }
+
+        const auto main_id = Python::builtins()["id"_key](Python::import("sys")["modules"_key]).as<long>();
+        for (auto& id : ids)
+            assert(id.get() != main_id);
+
+        // a pool can be destroyed while holding the main GIL, its queued tasks still run
+        std::vector<std::future<long>> queued;
+        {
+            Python::InterpreterPool pool(2);
+            for (long i = 0; i < 8; i++)
+                queued.push_back(pool.submit([i]()
+                {
+                    return static_cast<long>(Python::import("json")["dumps"_key](i).as<std::string>().size());
+                }));
+        }
+        for (auto& size : queued)
+            assert(size.get() == 1);
+
+        std::cout << "4999950000 => ";
+        Python::builtins()["sum"_key](Python::builtins()["range"_key](100000)).print();
+    # endif
+}
@@ -0,0 +1,67 @@
+// TEST: range-based for (list, tuple, any iterable), iter/next
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    long sum = 0;
+    for (auto item : Python::list(1, 2, 3, 4))
+        sum += item.as<long>();
+    assert(sum == 10);
+
+    std::string joined;
+    for (auto item : Python::tuple("a", "b", "c"))
+        joined += item.as<std::string>();
+    assert(joined == "abc");
+
+    // generic path, through __iter__
+    sum = 0;
+    for (auto item : Python::builtins()["range"_key](1000))
+        sum += item.as<long>();
+    assert(sum == 999 * 1000 / 2);
+
+    std::cout << "a b => ";
+    for (auto key : Python::dict("a", 1, "b", 2))
+        std::cout << key.as<std::string>() << " ";
+    std::cout << std::endl;
+
+    // empty iterables
+    for ([[maybe_unused]] auto item : Python::list())
+        assert(false);
+    for ([[maybe_unused]] auto item : Python::builtins()["range"_key](0))
+        assert(false);
+
+    // items don't outlive the loop
+    auto list = Python::list(Python::list(1, 10), Python::list(2, 20));
+    [[maybe_unused]] const auto refcnt = Py_REFCNT(static_cast<PyObject*>(Python(list[0])));
+    for (auto item : list)
+        assert(item.size() == 2);
+    assert(Py_REFCNT(static_cast<PyObject*>(Python(list[0]))) == refcnt);
+
+    // the list can shrink during the loop
+    auto shrinking = Python::list(1, 2, 3, 4);
+    int count = 0;
+    for ([[maybe_unused]] auto item : shrinking)
+    {
+        shrinking.method("pop"_key);
+        count++;
+    }
+    assert(count == 2);
+
+    // next still signals the end with an exception
+    auto iter = Python::list(1, 2).iter();
+    iter.next();
+    iter.next();
+    [[maybe_unused]] bool raised = false;
+    try
+    {
+        iter.next();
+    }
+    catch (Python::StopIteration&)
+    {
+        raised = true;
+    }
+    assert(raised);
+}
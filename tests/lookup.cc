@@ -0,0 +1,135 @@
+// TEST: Lookup (cached lookups of module globals and class attributes, terminate), lookup, path
+
+// counts the refcount operations of the cache hits
+# ifndef PYDEBUG_COUNT
+    # define PYDEBUG_COUNT
+# endif
+
+# include <cassert>
+
+# include "python.hh"
+
+static PyObject* ptr(Python o)
+{
+    return o;
+}
+
+/// Number of INCREF/DECREF done by \var func
+template <typename F>
+static std::size_t refcount_ops(F func)
+{
+    const auto start = PyRef::refcount_ops;
+    func();
+    return PyRef::refcount_ops - start;
+}
+
+int main()
+{
+    // a handle outliving the interpreter
+    Python::Lookup outlived("path.join");
+
+    {
+        // module globals are cached
+        auto os = Python::import("os");
+        Python::Lookup getcwd("getcwd"_key);
+        assert(ptr(getcwd(os)) == ptr(os["getcwd"_key]));
+        assert(ptr(getcwd(os)) == ptr(os.lookup("getcwd"_key)));
+
+        // ...until the module changes
+        Python::Context context;
+        context.exec("import sys, types\n"
+                     "module = sys.modules['lookup_test'] = types.ModuleType('lookup_test')\n"
+                     "module.value = 1\n"
+                     "class A:\n    x = 2\n"
+                     "class B(A):\n    pass");
+
+        auto module = Python::import("lookup_test");
+        Python::Lookup value("value"_key);
+        assert(value(module).as<int>() == 1);
+        context.exec("module.value = 3");
+        assert(value(module).as<int>() == 3);
+
+        // classes are cached until they (or their bases) change too
+        auto globals = context.globals();
+        Python::Lookup x("x"_key);
+        auto type = globals.lookup("B"_key);
+        assert(x(type).as<int>() == 2);
+        context.exec("A.x = 4");
+        assert(x(type).as<int>() == 4);
+
+        // dotted paths are resolved once
+        Python::Lookup join("path.join");
+        assert(ptr(join(os)) == ptr(Python(os["path"_key]).attr("join"_key)));
+        assert(ptr(join(os)) == ptr(os.path("path.join")));
+
+        std::cout << "'a/b' => ";
+        join(os)("a", "b").print();
+
+        Python::Lookup path("B.x");
+        std::cout << "4 => ";
+        path(globals).print();
+        context.exec("A.x = 5");
+        std::cout << "5 => ";
+        path(globals).print();
+
+        // other objects, like plain dicts, are looked up each time and not kept alive
+        auto list = Python::list(1, 2);
+        [[maybe_unused]] const auto refcnt = Py_REFCNT(ptr(list));
+        Python::Lookup append("append"_key);
+        append(list)(3);
+        assert(Py_REFCNT(ptr(list)) == refcnt);
+        std::cout << "[1, 2, 3] => ";
+        list.print();
+
+        auto dict = Python::dict("value", 6);
+        [[maybe_unused]] const auto dict_refcnt = Py_REFCNT(ptr(dict));
+        assert(value(dict).as<int>() == 6 && Py_REFCNT(ptr(dict)) == dict_refcnt);
+
+        // a handle keeps a single object, the previous one is released
+        auto other = context.eval("type('C', (), {'x': 7})");
+        [[maybe_unused]] const auto other_refcnt = Py_REFCNT(ptr(other));
+        assert(x(other).as<int>() == 7 && Py_REFCNT(ptr(other)) > other_refcnt);
+        assert(x(type).as<int>() == 5 && Py_REFCNT(ptr(other)) == other_refcnt);
+
+        [[maybe_unused]] bool raised = false;
+        try
+        {
+            Python::Lookup missing("missing"_key);
+            missing(module);
+        }
+        catch (Python::KeyError&)
+        {
+            raised = true;
+        }
+        assert(raised);
+
+        raised = false;
+        try
+        {
+            Python::Lookup missing("path.missing");
+            missing(os);
+        }
+        catch (Python::AttributeError&)
+        {
+            raised = true;
+        }
+        assert(raised);
+        // a cached path is given back without being resolved again (timings in bench/access.cc)
+        [[maybe_unused]] const auto hit = refcount_ops([&]() { join(os); });
+        [[maybe_unused]] const auto miss = refcount_ops([&]() { os.path("path.join"); });
+        assert(hit < miss);
+
+        join.clear();
+        assert(refcount_ops([&]() { join(os); }) > hit);
+        assert(refcount_ops([&]() { join(os); }) == hit);
+        assert(ptr(join(os)) == ptr(os.path("path.join")));
+
+        outlived(os);
+    }
+
+    // the objects of a terminated interpreter are dropped, not released
+    Python::terminate();
+
+    auto os = Python::import("os");
+    assert(ptr(outlived(os)) == ptr(os.path("path.join")));
+}
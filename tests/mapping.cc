@@ -1,3 +1,5 @@
+# include <cassert>
+
 # include "python.hh"
 
 int main()
@@ -13,4 +15,49 @@ int main()
     // Dict getter
     auto sys = Python::import("sys");
     sys["stderr"].print();
+
+    // Interned keys
+    sys["stdout"_key].print();
+    Python(sys["path"_key]).attr("__class__"_key).print();
+
+    auto key = Python::Key("e");
+    auto dict = Python::dict("e", 2.71828);
+    dict[key].print();
+
+    // keys built from a reused buffer keep their own text
+    std::string buffer = "first";
+    auto first = Python::Key(buffer);
+    buffer = "other";
+    assert(first.str() == "first" && Python::Key(buffer).str() == "other");
+
+    // Dict setter
+    dict["pi"_key] = 3.14159;
+    dict.print();
+
+    // Bulk construction from C++ maps and ranges of pairs
+    std::cout << "{'a': 1, 'b': 2} => ";
+    Python::dict(std::map<std::string, int>{{"a", 1}, {"b", 2}}).print();
+
+    std::unordered_map<int, double> squares;
+    for (int i = 0; i < 100000; i++)
+        squares[i] = i * 0.5;
+    auto big = Python::dict(squares);
+    assert(big.size() == 100000);
+    assert(Python(big[Python(99999)]).as<double>() == 99999 * 0.5);
+
+    std::cout << "{1: 'x', 2: 'y'} => ";
+    Python::dict(std::vector<std::pair<int, std::string>>{{1, "x"}, {2, "y"}}).print();
+
+    std::cout << "{'a': 1, 'b': 2} => ";
+    Python::dict(Python::list("a", "b"), Python::tuple(1, 2)).print();
+
+    // Bulk update of an existing dict
+    auto config = Python::dict("host", "localhost", "port", 80);
+    config.update(std::map<std::string, int>{{"port", 8080}, {"workers", 4}});
+    std::cout << "{'host': 'localhost', 'port': 8080, 'workers': 4} => ";
+    config.print();
+
+    config.merge(Python::dict("port", 1, "debug", true), false);
+    std::cout << "{'host': 'localhost', 'port': 8080, 'workers': 4, 'debug': True} => ";
+    config.print();
 }
\ No newline at end of file
@@ -15,6 +15,10 @@ int main()
     std::cout << "234 & 63 =    ";  (Python(234) & Python(63)).print();
     std::cout << "255 ^ 213 =   ";  (Python(255) ^ Python(213)).print();
     std::cout << "32 | 8 | 2 =  ";  (Python(32) | Python(8) | Python(2)).print();
+    std::cout << "85 // 2 =     ";  (Python(85).floordiv(Python(2))).print();
+    std::cout << "2 ** 5 + 10 = ";  (Python(2).pow(Python(5)) + Python(10)).print();
+    std::cout << "2 ** 10 % 982 = "; (Python(2).pow(Python(10), Python(982))).print();
+    std::cout << "abs(-42) =    ";  (Python(-42).abs()).print();
 
     std::cout << "\n";
 
@@ -40,6 +44,19 @@ int main()
     std::cout << "234 & 63 =    ";  h &= Python(63);    h.print();
     std::cout << "255 ^ 213 =   ";  i ^= Python(213);   i.print();
     std::cout << "32 | 8 | 2 =  ";  j |= Python(8) |= Python(2);    j.print();
+    std::cout << "85 // 2 =     ";  auto k = Python(85); k.ifloordiv(Python(2));    k.print();
+
+    // inplace on mutable objects keeps the same object
+    auto l = Python::list(1, 2);
+    auto m = l;
+    l += Python::list(3, 4);
+    std::cout << "[1, 2, 3, 4]: ";  m.print();
+    assert(static_cast<PyObject*>(l) == static_cast<PyObject*>(m));
+
+    // sequence helpers
+    std::cout << "True:  ";         Python::list(1, 2, 3).contains(Python(2)).print();
+    std::cout << "2:     ";         Python::list(1, 2, 2).count_of(Python(2)).print();
+    std::cout << "1:     ";         Python::list(1, 2, 2).index_of(Python(2)).print();
 
     // concat
     std::cout << "Hello World: ";   (Python("Hello") + Python(' ') + Python("World")).print();
@@ -0,0 +1,55 @@
+// TEST: move semantics, steal/borrow, no leaked references
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    auto a = Python::list(1, 2, 3);
+    PyObject* ptr = a;
+    [[maybe_unused]] const auto count = Py_REFCNT(ptr);
+
+    // copy shares the reference
+    auto b = a;
+    assert(Py_REFCNT(ptr) == count + 1);
+
+    // move transfers it
+    auto c = std::move(b);
+    assert(Py_REFCNT(ptr) == count + 1);
+    assert(b.is_valid() == false);
+
+    // assignment releases the previous object
+    c = Python::tuple(1, 2);
+    assert(Py_REFCNT(ptr) == count);
+
+    // borrow takes a new reference, steal doesn't
+    {
+        auto borrowed = Python::borrow(ptr);
+        assert(Py_REFCNT(ptr) == count + 1);
+
+        Py_INCREF(ptr);
+        auto stolen = Python::steal(ptr);
+        assert(Py_REFCNT(ptr) == count + 2);
+    }
+    assert(Py_REFCNT(ptr) == count);
+
+    // containers hold the only reference to their items
+    auto item = Python(std::string("item"));
+    [[maybe_unused]] const auto item_count = Py_REFCNT(static_cast<PyObject*>(item));
+    {
+        auto list = Python::list(item, item);
+        auto tuple = Python::tuple(item, item);
+        assert(Py_REFCNT(static_cast<PyObject*>(item)) == item_count + 4);
+    }
+    assert(Py_REFCNT(static_cast<PyObject*>(item)) == item_count);
+
+    // lookups don't leak
+    auto sys = Python::import("sys");
+    auto out = Python(sys["stdout"_key]);
+    [[maybe_unused]] const auto out_count = Py_REFCNT(static_cast<PyObject*>(out));
+    {
+        Python again = sys["stdout"_key];
+    }
+    assert(Py_REFCNT(static_cast<PyObject*>(out)) == out_count);
+}
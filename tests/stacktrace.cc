@@ -0,0 +1,80 @@
+// TEST: StackTrace (capture, skip, empty, signal-safe write), native trace of PythonError
+
+# ifndef BACKTRACE
+    # define BACKTRACE
+# endif
+
+# include <algorithm>
+# include <cassert>
+# include <csignal>
+
+# include <unistd.h>
+
+# include "python.hh"
+
+__attribute__((noinline)) StackTrace capture(unsigned skip)
+{
+    return StackTrace(skip);
+}
+
+static int pipe_fds[2];
+static volatile std::sig_atomic_t signal_frames = 0;
+
+static void on_signal(int)
+{
+    // captured and written without allocation in the handler
+    StackTrace trace;
+    trace.write(pipe_fds[1]);
+    signal_frames = trace.size();
+}
+
+int main()
+{
+    auto inner = capture(0);
+    auto outer = capture(1);
+
+    // skipping "capture" gives the frames of main
+    assert(inner.size() > 1 && outer.size() == inner.size() - 1);
+    for (std::size_t i = 0; i < outer.size(); i++)
+        assert(outer[i] == inner[i + 1] || i == 0);
+
+    // symbolized on demand
+    assert(inner.symbols().size() == inner.size());
+
+    std::cout << "1 => ";
+    std::cout << (inner.symbols()[inner.size() - 1].empty() == false) << std::endl;
+
+    // empty traces are not captured
+    assert(StackTrace(StackTrace::empty).size() == 0);
+
+    // written from a signal handler, one address per line
+    [[maybe_unused]] int ret = pipe(pipe_fds);
+    assert(ret == 0);
+    std::signal(SIGUSR1, on_signal);
+    std::raise(SIGUSR1);
+    close(pipe_fds[1]);
+
+    std::string written;
+    char buffer[256];
+    for (ssize_t size; (size = read(pipe_fds[0], buffer, sizeof(buffer))) > 0; )
+        written.append(buffer, size);
+    close(pipe_fds[0]);
+
+    assert(signal_frames > 0);
+    assert(written.compare(0, 2, "0x") == 0);
+    assert(std::count(written.begin(), written.end(), '\n') == signal_frames);
+
+    // errors keep the native stack where they were raised
+    try
+    {
+        Python::import("this_module_does_not_exist");
+    }
+    catch (Python::ImportError& e)
+    {
+        assert(e.trace().size() > 0);
+
+        // ...without the frames of err and raise, even when optimized
+        [[maybe_unused]] const auto& top = e.trace().symbols()[0];
+        assert(top.find("Python::raise") == std::string::npos && top.find("Python::err") == std::string::npos);
+    }
+}
@@ -0,0 +1,60 @@
+// TEST: stream (ranges, producers, move-only producers, chunks)
+
+# include <cassert>
+# include <memory>
+
+# include "python.hh"
+
+int main()
+{
+    auto sum = Python::builtins()["sum"_key];
+
+    // temporary range, moved into the stream
+    std::cout << "6 => ";
+    sum(Python::stream(std::vector<int>{1, 2, 3})).print();
+
+    // named range, used in place
+    std::list<std::string> words = {"a", "b", "c"};
+    std::cout << "'abc' => ";
+    Python("").method("join"_key, Python::stream(words)).print();
+
+    // producer, pulled lazily
+    int produced = 0;
+    auto counter = Python::stream([&produced]() -> std::optional<int>
+    {
+        if (produced == 1000000)
+            return std::nullopt;
+
+        return produced++;
+    });
+
+    auto first = counter.next();
+    assert(first.as<int>() == 0 && produced == 1);
+
+    std::cout << "499999500000 => ";
+    sum(counter).print();
+    assert(produced == 1000000);
+
+    // exhausted streams stay exhausted
+    assert(PyIter_Next(counter) == nullptr && PyErr_Occurred() == nullptr);
+
+    // chunks, the last one being partial
+    std::cout << "[[0, 1, 2], [3, 4, 5], [6]] => ";
+    Python::list(Python::stream(std::vector<int>{0, 1, 2, 3, 4, 5, 6}, 3)).print();
+
+    // C++ exceptions are raised in python
+    auto failing = Python::stream([]() -> std::optional<int> { throw std::runtime_error("no more data"); });
+    assert(PyIter_Next(failing) == nullptr && PyErr_ExceptionMatches(PyExc_RuntimeError));
+    PyErr_Clear();
+
+    // move-only producers are held as they are
+    auto remaining = std::make_unique<int>(3);
+    auto countdown = Python::stream([remaining = std::move(remaining)]() -> std::optional<int>
+    {
+        if (*remaining == 0)
+            return std::nullopt;
+        return (*remaining)--;
+    });
+    std::cout << "[3, 2, 1] => ";
+    Python::list(countdown).print();
+}
@@ -0,0 +1,83 @@
+// TEST: as_utf8_view, string, utf16, utf32, wstring, TypeError on non-str, construction (UTF-8, string_view, ascii, interned)
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    // no copy, the view points into the str object
+    auto ascii = Python("hello");
+    [[maybe_unused]] auto view = ascii.as_utf8_view();
+    assert(view == "hello");
+    assert(view.data() == ascii.as_utf8_view().data());
+
+    // any length (no more 200 characters limit)
+    const std::string long_string(10000, 'x');
+    assert(Python(long_string).string() == long_string);
+    assert(Python(long_string).utf32().size() == 10000);
+
+    // proper transcoding: é (2 bytes in UTF-8), € (3 bytes), 😀 (outside of the BMP)
+    auto unicode = Python::eval("'\\u00e9\\u20ac\\U0001F600'", Py_eval_input, Python::dict(), Python::dict());
+    assert(unicode.string() == "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+    assert(unicode.utf8() == unicode.string());
+    assert(unicode.utf32() == U"é€\U0001F600");
+    assert(unicode.utf16() == u"é€\U0001F600");
+    assert(unicode.utf16().size() == 4);
+    assert(unicode.wstring() == L"é€\U0001F600");
+
+    std::cout << "3 => ";
+    Python(static_cast<long>(unicode.ucs4().size())).print();
+
+    // construction decodes UTF-8 (not Latin-1)
+    const std::string utf8 = "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80";
+    assert(Python(utf8).size() == 3);
+    assert(Python(utf8) == unicode);
+    assert(Python(std::u16string(u"é€\U0001F600")) == unicode);
+    assert(Python(std::u32string(U"é€\U0001F600")) == unicode);
+    assert(Python(std::wstring(L"é€\U0001F600")) == unicode);
+
+    // string_view, without temporary string
+    const std::string_view line = "key=value";
+    std::cout << "'key' => ";
+    Python(line.substr(0, 3)).print();
+
+    // known ASCII data
+    std::cout << "'value' => ";
+    Python(line.substr(4), Python::ascii).print();
+
+    // interned strings are shared
+    auto first = Python(std::string("identifier_") + "name", Python::interned);
+    auto second = Python(std::string_view("identifier_name"), Python::interned);
+    assert(static_cast<PyObject*>(first) == static_cast<PyObject*>(second));
+
+    // lists of strings are decoded too
+    std::cout << "['é'] => ";
+    Python::list(std::vector<std::string>{"\xc3\xa9"}).print();
+
+    // empty string
+    assert(Python("").as_utf8_view().empty() && Python("").utf16().empty() && Python("").wstring().empty());
+
+    // only str objects have code points
+    int raised = 0;
+    for (auto func : { &Python::ucs4, &Python::utf32 })
+    {
+        try
+        {
+            (Python(1).*func)();
+        }
+        catch (Python::TypeError&)
+        {
+            raised++;
+        }
+    }
+    try
+    {
+        Python::list(1, 2).utf16();
+    }
+    catch (Python::TypeError&)
+    {
+        raised++;
+    }
+    assert(raised == 3);
+}
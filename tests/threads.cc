@@ -0,0 +1,61 @@
+// TEST: GILAcquire, GILRelease, per-thread error state
+
+# include <cassert>
+# include <thread>
+
+# include "python.hh"
+
+int main()
+{
+    Python::mute_errors(false);
+
+    {
+        // let the workers take the GIL
+        Python::GILRelease release;
+
+        std::vector<std::thread> workers;
+        for (int id = 0; id < 4; id++)
+            workers.emplace_back([id]()
+            {
+                long native = 0;
+                {
+                    Python::GILAcquire gil;
+
+                    // errors muted for this thread only
+                    Python::mute_errors(true);
+                    Python::import("this_module_does_not_exist");
+                    assert(PyErr_ExceptionMatches(PyExc_ModuleNotFoundError));
+                    PyErr_Clear();
+
+                    // long native computation without the GIL
+                    {
+                        Python::GILRelease release;
+                        for (long i = 0; i < 1000000; i++)
+                            native += i % 7;
+                    }
+
+                    auto sum = Python::builtins()["sum"_key](Python::list(id, native));
+                    Python::import("sys")["modules"_key].method("setdefault"_key, std::string("worker"), sum);
+                }
+            });
+
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    std::cout << "True => ";
+    Python(Python::import("sys")["modules"_key]).contains(Python(std::string("worker"))).print();
+
+    // still raising in the main thread
+    [[maybe_unused]] bool raised = false;
+    try
+    {
+        Python::import("this_module_does_not_exist");
+    }
+    catch (Python::PythonError&)
+    {
+        PyErr_Clear();
+        raised = true;
+    }
+    assert(raised);
+}
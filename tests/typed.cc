@@ -0,0 +1,89 @@
+// TEST: PyList, PyTuple, PyDict, PyStr, PyInt (typed handles)
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    // checked once, then indexed without dispatch
+    PyList list(Python::list(1, 2, 3));
+    long sum = 0;
+    for (Py_ssize_t i = 0; i < list.size(); i++)
+        sum += list[i].as<long>();
+    assert(sum == 6);
+
+    list.set(0, Python(10));
+    list.append(Python(4));
+    std::cout << "[10, 2, 3, 4] => ";
+    list.print();
+
+    // items are borrowed, nothing is left behind
+    auto item = list[1];
+    [[maybe_unused]] const auto refcnt = Py_REFCNT(static_cast<PyObject*>(item));
+    for (Py_ssize_t i = 0; i < list.size(); i++)
+        assert(list[i].is_valid());
+    assert(Py_REFCNT(static_cast<PyObject*>(item)) == refcnt);
+
+    PyTuple tuple(Python::tuple("a", 2));
+    assert(tuple.size() == 2 && tuple[1].as<int>() == 2);
+
+    // dict accessors
+    PyDict dict(Python::dict("a", 1));
+    dict.set("b"_key, Python(2));
+    assert(dict.size() == 2);
+    assert(dict.contains("a"_key) && dict.contains(Python("c")) == false);
+    assert(dict["b"_key].as<int>() == 2);
+    assert(dict.get("c"_key, Python(3)).as<int>() == 3);
+
+    [[maybe_unused]] bool raised = false;
+    try
+    {
+        auto missing = dict["c"_key];
+    }
+    catch (Python::KeyError&)
+    {
+        raised = true;
+    }
+    assert(raised);
+
+    // tuple keys are kept whole in the KeyError
+    raised = false;
+    try
+    {
+        auto missing = dict[Python::tuple(1, 2)];
+    }
+    catch (Python::KeyError& e)
+    {
+        raised = true;
+        auto args = e.value().attr("args"_key);
+        assert(PyTuple_GET_SIZE(static_cast<PyObject*>(args)) == 1);
+        std::cout << "((1, 2),) => ";
+        args.print();
+    }
+    assert(raised);
+
+    PyStr str(Python("héllo"));
+    assert(str.size() == 5 && str[1] == U'é');
+
+    PyInt integer(Python(1) << Python(40));
+    assert(integer.value() == 1LL << 40);
+    assert(Python::try_([&]() { return integer.value<int>(); }) == std::nullopt);
+
+    // a typed handle is still a Python
+    std::cout << "2 => ";
+    Python::builtins()["len"_key](dict).print();
+
+    // wrong types are refused
+    raised = false;
+    try
+    {
+        PyList wrong(tuple);
+    }
+    catch (Python::TypeError&)
+    {
+        raised = true;
+        assert(PyList::is(tuple) == false && PyTuple::is(tuple));
+    }
+    assert(raised);
+}
@@ -0,0 +1,43 @@
+// TEST: keys, values, items (views over a dict)
+
+# include <cassert>
+
+# include "python.hh"
+
+int main()
+{
+    auto dict = Python::dict("a", 1, "b", 2, "c", 3);
+
+    std::string keys;
+    for (auto key : dict.keys())
+        keys += key.as<std::string>();
+    assert(keys == "abc");
+
+    long sum = 0;
+    for (auto value : dict.values())
+        sum += value.as<long>();
+    assert(sum == 6);
+
+    std::cout << "a=1 b=2 c=3 => ";
+    for (auto [key, value] : dict.items())
+        std::cout << key.as<std::string>() << "=" << value.as<long>() << " ";
+    std::cout << std::endl;
+
+    // the items are borrowed, nothing is left behind
+    auto item = Python(dict["a"_key]);
+    [[maybe_unused]] const auto refcnt = Py_REFCNT(static_cast<PyObject*>(item));
+    for (auto [key, value] : dict.items())
+        assert(value.is_valid());
+    assert(Py_REFCNT(static_cast<PyObject*>(item)) == refcnt);
+
+    // empty dict
+    for ([[maybe_unused]] auto key : Python::dict().keys())
+        assert(false);
+
+    // conversion to lists
+    assert(dict.keys().size() == 3);
+    std::cout << "['a', 'b', 'c'] => ";
+    Python(dict.keys()).print();
+    std::cout << "[('a', 1), ('b', 2), ('c', 3)] => ";
+    Python(dict.items()).print();
+}